@@ -7,6 +7,14 @@
  * upper case characters (and SPACE) in the alphabet
  * (Used ASCII table in http://www.asciitable.com )
  * - Changed lowestChar from 'a' to ' ' highestChar from 'z' to '~'
+ * - Changed MAXC from 90 to 95 so that '{' to '~' stay inside the g matrix
+ * - Changed MAXS from 1000 to 6000 to fit the 100_patterns.txt data sets
+ * - Changed out from an int mask to std::bitset<MAXW> to allow more than
+ * 32 keywords
+ * - buildMatchingMachine clears only the states it allocates instead of
+ * the whole g matrix
+ * - Moved the declarations to ac.h; define AC_NO_MAIN to link the machine
+ * into another program (e.g. code/bench.cc)
  *
  */
 #include <algorithm>
@@ -29,6 +37,10 @@
 #include <list>
 #include <map>
 #include <set>
+
+#include "ac.h"
+#include "../code/counters/counters.h"
+
 using namespace std;
 #define foreach(x, v) for (typeof (v).begin() x=(v).begin(); x !=(v).end(); ++x)
 #define For(i, a, b) for (int i=(a); i<(b); ++i)
@@ -38,13 +50,7 @@ using namespace std;
 // Aho-Corasick's algorithm, as explained in  http://dx.doi.org/10.1145/360825.360855  //
 /////////////////////////////////////////////////////////////////////////////////////////
 
-const int MAXS = 1000; //6 * 50 + 10; // Max number of states in the matching machine.
-// Should be equal to the sum of the length of all keywords.
-
-const int MAXC = 90;// Number of characters in the alphabet.
-//change MAXC to include special and upper case characters
-
-int out[MAXS]; // Output for each state, as a bitwise mask.
+bitset<MAXW> out[MAXS]; // Output for each state, as a bitwise mask.
 // Bit i in this mask is on if the keyword with index i appears when the
 // machine enters this state.
 
@@ -52,10 +58,18 @@ int out[MAXS]; // Output for each state, as a bitwise mask.
 int f[MAXS]; // Failure function
 int g[MAXS][MAXC]; // Goto function, or -1 if fail.
 
+// Clears the tables of a newly allocated state. Only the states in use are
+// cleared, so that building a small machine doesn't touch the whole g matrix.
+static void initState(int state) {
+    out[state].reset();
+    f[state] = -1;
+    memset(g[state], -1, sizeof g[state]);
+}
+
 // Builds the string matching machine.
 //
 // words - Vector of keywords. The index of each keyword is important:
-//         "out[state] & (1 << i)" is > 0 if we just found word[i] in the text.
+//         "out[state][i]" is on if we just found word[i] in the text.
 // lowestChar - The lowest char in the alphabet. Defaults to ' '.
 // highestChar - The highest char in the alphabet. Defaults to '~'.
 //               "highestChar - lowestChar" must be <= MAXC, otherwise we will
@@ -63,10 +77,8 @@ int g[MAXS][MAXC]; // Goto function, or -1 if fail.
 //
 // Returns the number of states that the new machine has.
 // States are numbered 0 up to the return value - 1, inclusive.
-int buildMatchingMachine(const vector<string> &words, char lowestChar = ' ', char highestChar = '~') {
-    memset(out, 0, sizeof out);
-    memset(f, -1, sizeof f);
-    memset(g, -1, sizeof g);
+int buildMatchingMachine(const vector<string> &words, char lowestChar, char highestChar) {
+    initState(0);
     
     int states = 1; // Initially, we just have the 0 state
     
@@ -76,11 +88,12 @@ int buildMatchingMachine(const vector<string> &words, char lowestChar = ' ', cha
         for (int j = 0; j < keyword.size(); ++j) {
             int c = keyword[j] - lowestChar;
             if (g[currentState][c] == -1) { // Allocate a new node
+                initState(states);
                 g[currentState][c] = states++;
             }
             currentState = g[currentState][c];
         }
-        out[currentState] |= (1 << i); // There's a match of keywords[i] at node currentState.
+        out[currentState].set(i); // There's a match of keywords[i] at node currentState.
     }
     
     // State 0 should have an outgoing edge for all characters.
@@ -129,10 +142,13 @@ int buildMatchingMachine(const vector<string> &words, char lowestChar = ' ', cha
 
 // Returns the next state the machine will transition to. This is an integer between
 // 0 and the number of states - 1, inclusive.
-int findNextState(int currentState, char nextInput, char lowestChar = ' ') {
+int findNextState(int currentState, char nextInput, char lowestChar) {
     int answer = currentState;
     int c = nextInput - lowestChar;
-    while (g[answer][c] == -1) answer = f[answer];
+    while (g[answer][c] == -1) {
+        COUNT(kAcFailureHops);
+        answer = f[answer];
+    }
     return g[answer][c];
 }
 
@@ -160,9 +176,9 @@ int findNextState(int currentState, char nextInput, char lowestChar = ' ') {
 // int currentState = 0;
 // for (int i = 0; i < text.size(); ++i) {
 //    currentState = findNextState(currentState, text[i], ' ');
-//    if (out[currentState] == 0) continue; // Nothing new, let's move on to the next character.
+//    if (out[currentState].none()) continue; // Nothing new, let's move on to the next character.
 //    for (int j = 0; j < keywords.size(); ++j) {
-//        if (out[currentState] & (1 << j)) { // Matched keywords[j]
+//        if (out[currentState][j]) { // Matched keywords[j]
 //            cout << "Keyword " << keywords[j] << " appears from "
 //                 << i - keywords[j].size() + 1 << " to " << i << endl;
 //        }
@@ -181,6 +197,7 @@ int findNextState(int currentState, char nextInput, char lowestChar = ' ') {
 /////////////////////////////////////////////////////////////////////////////////////////
 
 
+#ifndef AC_NO_MAIN
 int main(int argc, char * argv[]){
     // pass in the filename of the text first
     // pass in the filename of the pattern second
@@ -199,9 +216,9 @@ int main(int argc, char * argv[]){
     int currentState = 0;
     for (int i = 0; i < text.size(); ++i) {
         currentState = findNextState(currentState, text[i], ' ');
-        if (out[currentState] == 0) continue; // Nothing new, let's move on to the next character.
+        if (out[currentState].none()) continue; // Nothing new, let's move on to the next character.
         for (int j = 0; j < keywords.size(); ++j) {
-            if (out[currentState] & (1 << j)) { // Matched keywords[j]
+            if (out[currentState][j]) { // Matched keywords[j]
                 occurance++;
             }
         }
@@ -210,4 +227,5 @@ int main(int argc, char * argv[]){
     cout << "pattern found: " << occurance << " times" << endl;
     return occurance;
     
-}
\ No newline at end of file
+}
+#endif  // AC_NO_MAIN
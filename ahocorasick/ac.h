@@ -0,0 +1,26 @@
+/*
+ * Declarations of the Aho-Corasick matching machine implemented in ac.cpp.
+ * See ac.cpp for the description of each function and how to use them.
+ */
+#ifndef AC_H_
+#define AC_H_
+
+#include <bitset>
+#include <string>
+#include <vector>
+
+const int MAXS = 6000; // Max number of states in the matching machine.
+// Should be equal to the sum of the length of all keywords.
+
+const int MAXC = 95; // Number of characters in the alphabet (' ' to '~').
+
+const int MAXW = 128; // Max number of keywords in the machine.
+
+extern std::bitset<MAXW> out[MAXS];
+extern int f[MAXS];
+extern int g[MAXS][MAXC];
+
+int buildMatchingMachine(const std::vector<std::string> &words, char lowestChar = ' ', char highestChar = '~');
+int findNextState(int currentState, char nextInput, char lowestChar = ' ');
+
+#endif  // AC_H_
@@ -1,15 +1,35 @@
 // BoyreMoore.cpp : Defines the entry point for the console application.
 
+// The precompiled header has to come first: under /Yu MSVC skips
+// everything before it.
 #include "stdafx.h"
+#ifdef _MSC_VER
+#include <conio.h>
+#endif
 #include <iostream>
 #include <string>
-#include <conio.h>
+#include <cstring>
+
+#include "BoyreMoore.h"
+#include "../../../counters/counters.h"
 
 using namespace std;
 
-/*char* extractalphabet(char* text){
+// Returns the sorted set of distinct characters of the text.
+// The caller owns the returned string.
+char* extractalphabet(const char *text){
+	bool seen[256]={false};
+	for(const char *p=text;*p;p++)
+		seen[(unsigned char)*p]=true;
+	char *alphabet=new char[257];
+	int s=0;
+	for(int c=1;c<256;c++)
+		if(seen[c])
+			alphabet[s++]=(char)c;
+	alphabet[s]='\0';
+	return alphabet;
 }
-*/
+
 void printtable(int **table,int r,int c){
 	for(int i=0;i<r;i++){
 		for(int j=0;j<c;j++)
@@ -18,16 +38,15 @@ void printtable(int **table,int r,int c){
 	}
 }
 
-int** preprocess(char *pattern, char *alphabet){
+int** preprocess(const char *pattern, const char *alphabet){
 	int k=strlen(pattern),s=strlen(alphabet);
 	//initalize table with all zeros
 	int** table = new int* [k];
-	char *part = new char [k];
+	char *part = new char [k+1];
     for (int i = 0; i < k; i++){
 		table[i] = new int[s];
-		part[k]='\0';
 		for (int j=0; j<s; j++)
-			table[i][j]=0;	
+			table[i][j]=0;
 	}
 	//update table based on bad character rule
     for(int i=1;i<k;i++)
@@ -35,22 +54,61 @@ int** preprocess(char *pattern, char *alphabet){
 			table[i][j]=table[i-1][j];
 			if(pattern[i-1]==alphabet[j]){
 				strncpy (part,pattern,i);
-				table[i][j]=strrchr(part,alphabet[j])-part+1;		
+				part[i]='\0';
+				table[i][j]=strrchr(part,alphabet[j])-part+1;
 			}
 		}
+	delete[] part;
 	//printtable(table,k,s);
 	return table;
 }
 
-int bmsearch(char *text, char *pattern, int** table){
-	int n=strlen(text),k=strlen(pattern);
-	
-	return 0;
+void freetable(int **table,int r){
+	for(int i=0;i<r;i++)
+		delete[] table[i];
+	delete[] table;
 }
 
-void boyremoore(char *text, char *pattern,char *alphabet){
-	int occ=0;
+// Scans the text from left to right comparing the pattern from right to left.
+// On a mismatch at position j the pattern is shifted so that the rightmost
+// occurrence of the mismatched text character in pattern[0..j-1] is aligned
+// with it (or past it, if there is none). Returns the number of occurrences.
+int bmsearch(const char *text, const char *pattern, int** table, const char *alphabet){
 	int n=strlen(text),k=strlen(pattern),s=strlen(alphabet);
+	int occ=0;
+
+	//map every character to its column in the table, -1 if not in alphabet
+	int column[256];
+	for(int c=0;c<256;c++)
+		column[c]=-1;
+	for(int j=0;j<s;j++)
+		column[(unsigned char)alphabet[j]]=j;
+
+	int l=0;
+	while(l<=n-k){
+		int j=k-1;
+		while(j>=0){
+			COUNT(kBmComparisons);
+			if(pattern[j]!=text[l+j])
+				break;
+			j--;
+		}
+		COUNT(kBmShifts);
+		if(j<0){
+			occ++;
+			l++;
+		}
+		else{
+			int x=column[(unsigned char)text[l+j]];
+			l+=j+1-(x<0?0:table[j][x]);
+		}
+	}
+	return occ;
+}
+
+void boyremoore(const char *text, const char *pattern,const char *alphabet){
+	int occ=0;
+	int k=strlen(pattern);
 
 	int **table;
 
@@ -58,17 +116,22 @@ void boyremoore(char *text, char *pattern,char *alphabet){
 	table=preprocess(pattern,alphabet);
 
 	cout<<"BM searching pattern...\n";
-	occ=bmsearch(text,pattern,table);
+	occ=bmsearch(text,pattern,table,alphabet);
 	cout<<"BM foud "<<occ<<" occurences";
+
+	freetable(table,k);
 }
 
+#ifndef BM_NO_MAIN
 int main(int argc, _TCHAR* argv[])
 {
-	char *text="GCATCGCAFAFAFTATACAGTACG";
-	char *pattern="GCAGAGAG";
-	char *alphabet="ACGT";//extractalphabet(text);
+	const char *text="GCATCGCAFAFAFTATACAGTACG";
+	const char *pattern="GCAGAGAG";
+	const char *alphabet="ACGT";//extractalphabet(text);
 	boyremoore(text,pattern,alphabet);
+#ifdef _MSC_VER
 	getch();
+#endif
 	return 0;
 }
-
+#endif
@@ -0,0 +1,12 @@
+// BoyreMoore.h : Boyer-Moore (bad character rule) preprocessing and search.
+//
+// The table built by preprocess() has k rows and |alphabet| columns:
+// table[i][j] is the 1-based position of the rightmost occurrence of
+// alphabet[j] in pattern[0..i-1], or 0 if there is none.
+
+#pragma once
+
+char* extractalphabet(const char *text);
+int** preprocess(const char *pattern, const char *alphabet);
+int bmsearch(const char *text, const char *pattern, int** table, const char *alphabet);
+void freetable(int **table, int r);
@@ -5,10 +5,15 @@
 
 #pragma once
 
+#ifdef _MSC_VER
 #include "targetver.h"
 
 #include <stdio.h>
 #include <tchar.h>
+#else
+// Other compilers (bench.sh, test.sh) only need the console entry point type
+typedef char _TCHAR;
+#endif
 
 
 
@@ -0,0 +1,845 @@
+/******************************************************************************
+ * Benchmark suite for pattern matching algorithms
+ *
+ * Times the preprocessing and the searching phases of every engine
+ * separately, on the data sets in data/, for the three experiments the final
+ * report is based on:
+ *
+ *   pattern-length  fixed text, one pattern of growing length
+ *                   (theory/figures/Pre-DNA-fixed-text.png);
+ *   pattern-count   fixed text, growing number of patterns;
+ *   text-length     fixed patterns (data/.../two_patterns.txt), growing text
+ *                   (theory/figures/pre-DNA-fixed-pattern.png,
+ *                   ser-DNA-fixed-pattern.png, ser-Natural-fixed-pattern.png).
+ *
+ * Every configuration is run --warmup times untimed and --reps times timed;
+ * the report contains min/mean/p50/p90/p99/max in microseconds per phase.
+ * Run it through bench.sh, e.g.  ./bench.sh --format=json --output=run.json
+ *
+ * Built with CXXFLAGS=-DPM_COUNTERS the report also contains the mean of the
+ * engines' instrumentation counters (see counters/counters.h) per phase, and
+ * with --perf=on the mean of the hardware counters (counters/perf_events.h).
+ *
+ * With --queries=N every run searches for the patterns N times in the same
+ * text: Boyer-Moore and Aho-Corasick preprocess the patterns for every query,
+ * the suffix tree is built once. The times are the totals over all queries.
+ *
+ * The engine "auto" searches through selector::Searcher, which picks the
+ * engine with the cost model of selector/engine_selector.h (reported as
+ * auto-bm, auto-ac or auto-st, with its whole time under "search").
+ * predicted_us is what the cost model expects for every engine phase.
+ * --calibrate=FILE fits the model to the times of bm, ac and st and saves
+ * it as the profile that --profile=FILE (cost_profile.txt) reads back.
+ *
+ * The engines bm-fixed and ac-fixed run the compile-time matchers of
+ * fixed/fixed_matchers.h, for the inputs fixed/data_patterns.cc compiled in.
+ * They are only built with -DPM_FIXED (FIXED=1 ./bench.sh), as compiling
+ * the matchers takes a while.
+ ******************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "counters/counters.h"
+#include "counters/perf_events.h"
+#ifdef PM_FIXED
+#include "fixed/data_patterns.h"
+#endif
+#include "selector/engine_selector.h"
+#include "suffixtree/suffix_tree.h"
+#include "../ahocorasick/ac.h"
+#include "BM/BoyreMoore/BoyreMoore/BoyreMoore.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::ostream;
+using std::string;
+using std::vector;
+
+namespace {
+
+const char kFirstCharacter = ' ';   // all engines work on ' ' to '~'
+const char kLastCharacter = '~';
+
+struct Options {
+  string data_dir;
+  vector<string> datasets;
+  vector<string> engines;
+  vector<string> experiments;
+  vector<size_t> pattern_lengths;
+  vector<size_t> pattern_counts;
+  size_t fixed_text_length;   // text used by pattern-length and pattern-count
+  size_t max_text_length;     // largest text used by text-length
+  size_t text_steps;
+  int warmup;
+  int repetitions;
+  bool perf;
+  size_t queries;             // searches for the patterns per run
+  string profile;
+  string calibrate;
+  string format;
+  string output;
+
+  Options()
+      : data_dir("../data")
+      , fixed_text_length(100000)
+      , max_text_length(500000)
+      , text_steps(5)
+      , warmup(1)
+      , repetitions(5)
+      , perf(false)
+      , queries(1)
+      , profile("cost_profile.txt")
+      , format("csv")
+  {
+    datasets.push_back("dna");
+    datasets.push_back("plain_text");
+    engines.push_back("bm");
+    engines.push_back("ac");
+    engines.push_back("st");
+    experiments.push_back("pattern-length");
+    experiments.push_back("pattern-count");
+    experiments.push_back("text-length");
+    const size_t lengths[] = {1, 2, 4, 8, 16, 32, 64, 100};
+    pattern_lengths.assign(lengths, lengths + 8);
+    const size_t counts[] = {1, 2, 5, 10, 20, 50, 100};
+    pattern_counts.assign(counts, counts + 7);
+  }
+};
+
+// Everything an engine gets; the alphabet is a property of the text and
+// is extracted once, outside of the timed region.
+struct Input {
+  string text;
+  string alphabet;
+  vector<string> patterns;
+  size_t queries;   // how many times the patterns are searched for
+};
+
+// Cost of one phase of one run of an engine
+struct Measurement {
+  double us;
+  unsigned long long software[counters::kCounterNum];
+  unsigned long long hardware[counters::kPerfEventNum];
+
+  Measurement()
+      : us(0)
+  {
+    std::fill(software, software + counters::kCounterNum, 0);
+    std::fill(hardware, hardware + counters::kPerfEventNum, 0);
+  }
+};
+
+// One run of an engine. For several patterns the engines that handle
+// one pattern at a time report the sum over all patterns.
+struct Sample {
+  Measurement preprocess;
+  Measurement search;
+  long matches;         // occurrences of the patterns in one query
+  const char* engine;   // the engine "auto" picked, NULL for the others
+
+  Sample()
+      : matches(0)
+      , engine(NULL)
+  {}
+};
+
+typedef Sample (*Engine) (const Input& input);
+typedef std::chrono::steady_clock Clock;
+
+// Hardware counters, NULL unless requested with --perf=on
+counters::PerfEvents* perf_events = NULL;
+
+// Picks the engine for "auto"
+selector::CostModel cost_model;
+
+// Measures the code between its construction and Stop(): the wall time,
+// the instrumentation counters (when compiled with -DPM_COUNTERS) and the
+// hardware counters (with --perf=on). The costs are added to *total.
+class Phase {
+ public:
+  explicit Phase(Measurement* total)
+      : total_(total)
+  {
+    std::copy(counters::values, counters::values + counters::kCounterNum,
+              software_);
+    if (perf_events)
+      perf_events->Start();
+    start_ = Clock::now();
+  }
+
+  void Stop() {
+    total_->us += std::chrono::duration<double, std::micro>(
+        Clock::now() - start_).count();
+    if (perf_events) {
+      unsigned long long hardware[counters::kPerfEventNum];
+      perf_events->Stop(hardware);
+      for (int i = 0; i < counters::kPerfEventNum; ++i)
+        total_->hardware[i] += hardware[i];
+    }
+    for (int i = 0; i < counters::kCounterNum; ++i)
+      total_->software[i] += counters::values[i] - software_[i];
+  }
+
+ private:
+  Measurement* total_;
+  unsigned long long software_[counters::kCounterNum];
+  Clock::time_point start_;
+};
+
+Sample RunBoyerMoore(const Input& input) {
+  Sample sample;
+  for (size_t q = 0; q < input.queries; ++q) {
+    long matches = 0;
+    for (size_t i = 0; i < input.patterns.size(); ++i) {
+      const char* pattern = input.patterns[i].c_str();
+
+      Phase preprocessing(&sample.preprocess);
+      int** table = preprocess(pattern, input.alphabet.c_str());
+      preprocessing.Stop();
+
+      Phase search(&sample.search);
+      matches += bmsearch(input.text.c_str(), pattern, table,
+                          input.alphabet.c_str());
+      search.Stop();
+
+      freetable(table, input.patterns[i].size());
+    }
+    sample.matches = matches;
+  }
+  return sample;
+}
+
+Sample RunAhoCorasick(const Input& input) {
+  Sample sample;
+  for (size_t q = 0; q < input.queries; ++q) {
+    Phase preprocessing(&sample.preprocess);
+    buildMatchingMachine(input.patterns, kFirstCharacter, kLastCharacter);
+    preprocessing.Stop();
+
+    Phase search(&sample.search);
+    long matches = 0;
+    int state = 0;
+    for (size_t i = 0; i < input.text.size(); ++i) {
+      state = findNextState(state, input.text[i], kFirstCharacter);
+      matches += out[state].count();
+    }
+    search.Stop();
+    sample.matches = matches;
+  }
+  return sample;
+}
+
+Sample RunSuffixTree(const Input& input) {
+  Sample sample;
+  Phase preprocessing(&sample.preprocess);
+  suffixtree::SuffixTree tree(input.text);
+  tree.Build();
+  preprocessing.Stop();
+
+  for (size_t q = 0; q < input.queries; ++q) {
+    Phase search(&sample.search);
+    long matches = 0;
+    for (size_t i = 0; i < input.patterns.size(); ++i)
+      matches += tree.Count(input.patterns[i]);
+    search.Stop();
+    sample.matches = matches;
+  }
+  return sample;
+}
+
+#ifdef PM_FIXED
+// The compiler has already built the tables of the fixed matchers,
+// so they have no preprocessing phase.
+Sample RunFixedBoyerMoore(const Input& input) {
+  Sample sample;
+  for (size_t q = 0; q < input.queries; ++q) {
+    long matches = 0;
+    for (size_t i = 0; i < input.patterns.size(); ++i) {
+      fixed::CountFunction count = fixed::FindBoyerMoore(input.patterns[i]);
+
+      Phase search(&sample.search);
+      matches += count(input.text.c_str(), input.text.size());
+      search.Stop();
+    }
+    sample.matches = matches;
+  }
+  return sample;
+}
+
+Sample RunFixedAhoCorasick(const Input& input) {
+  Sample sample;
+  fixed::CountFunction count = fixed::FindAhoCorasick(input.patterns);
+  for (size_t q = 0; q < input.queries; ++q) {
+    Phase search(&sample.search);
+    sample.matches = count(input.text.c_str(), input.text.size());
+    search.Stop();
+  }
+  return sample;
+}
+#endif
+
+// Searches the way a caller of the selector would; the preprocessing of
+// the engine it picks is part of the search time.
+Sample RunAuto(const Input& input) {
+  Sample sample;
+  Phase search(&sample.search);
+  selector::Searcher searcher(cost_model, input.text, input.queries);
+  for (size_t q = 0; q < input.queries; ++q)
+    sample.matches = searcher.Count(input.patterns);
+  search.Stop();
+  sample.engine = selector::kEngineNames[searcher.last_engine()];
+  return sample;
+}
+
+Engine FindEngine(const string& name) {
+  if (name == "bm") return RunBoyerMoore;
+  if (name == "ac") return RunAhoCorasick;
+  if (name == "st") return RunSuffixTree;
+#ifdef PM_FIXED
+  if (name == "bm-fixed") return RunFixedBoyerMoore;
+  if (name == "ac-fixed") return RunFixedAhoCorasick;
+#endif
+  if (name == "auto") return RunAuto;
+  return NULL;
+}
+
+// Returns an empty string if the engine can handle the input,
+// the reason why it can't otherwise.
+string CheckLimits(const string& engine, const Input& input) {
+#ifdef PM_FIXED
+  if (engine == "bm-fixed") {
+    for (size_t i = 0; i < input.patterns.size(); ++i)
+      if (!fixed::FindBoyerMoore(input.patterns[i]))
+        return "pattern not compiled in";
+    return "";
+  }
+  if (engine == "ac-fixed")
+    return fixed::FindAhoCorasick(input.patterns) ? "" :
+        "patterns not compiled in";
+#endif
+  if (engine != "ac")
+    return "";
+  size_t states = 1;
+  for (size_t i = 0; i < input.patterns.size(); ++i)
+    states += input.patterns[i].size();
+  if (input.patterns.size() > static_cast<size_t>(MAXW))
+    return "more than MAXW patterns";
+  if (states > static_cast<size_t>(MAXS))
+    return "more than MAXS states";
+  return "";
+}
+
+struct Statistics {
+  double min;
+  double mean;
+  double p50;
+  double p90;
+  double p99;
+  double max;
+};
+
+// Nearest-rank percentile of sorted values
+double Percentile(const vector<double>& sorted, double percent) {
+  size_t rank = static_cast<size_t>(std::ceil(percent / 100 * sorted.size()));
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+Statistics Summarize(vector<double> values) {
+  std::sort(values.begin(), values.end());
+  Statistics stats;
+  stats.min = values.front();
+  stats.max = values.back();
+  double sum = 0;
+  for (size_t i = 0; i < values.size(); ++i)
+    sum += values[i];
+  stats.mean = sum / values.size();
+  stats.p50 = Percentile(values, 50);
+  stats.p90 = Percentile(values, 90);
+  stats.p99 = Percentile(values, 99);
+  return stats;
+}
+
+struct Result {
+  string experiment;
+  string dataset;
+  string engine;
+  string phase;
+  size_t text_length;
+  size_t pattern_count;
+  size_t pattern_length;    // total length of all patterns
+  size_t alphabet_size;
+  size_t queries;
+  long matches;
+  Statistics time_us;
+  double predicted_us;    // by the cost model, < 0 if it has no model
+  double software[counters::kCounterNum];   // means over the repetitions
+  double hardware[counters::kPerfEventNum];
+};
+
+// Mean costs of the given phase of the samples
+void Average(const vector<Sample>& samples, Measurement Sample::*phase,
+             Result* result) {
+  vector<double> us;
+  std::fill(result->software, result->software + counters::kCounterNum, 0);
+  std::fill(result->hardware, result->hardware + counters::kPerfEventNum, 0);
+  for (size_t s = 0; s < samples.size(); ++s) {
+    const Measurement& measurement = samples[s].*phase;
+    us.push_back(measurement.us);
+    for (int i = 0; i < counters::kCounterNum; ++i)
+      result->software[i] += measurement.software[i] / double(samples.size());
+    for (int i = 0; i < counters::kPerfEventNum; ++i)
+      result->hardware[i] += measurement.hardware[i] / double(samples.size());
+  }
+  result->time_us = Summarize(us);
+}
+
+vector<Result> Measure(const Options& options, const string& experiment,
+                       const string& dataset, const Input& input) {
+  vector<Result> results;
+  size_t pattern_length = 0;
+  for (size_t i = 0; i < input.patterns.size(); ++i)
+    pattern_length += input.patterns[i].size();
+
+  selector::Workload workload;
+  workload.text_length = input.text.size();
+  workload.alphabet_size = input.alphabet.size();
+  workload.pattern_count = input.patterns.size();
+  workload.pattern_length = pattern_length;
+  workload.queries = input.queries;
+
+  for (size_t e = 0; e < options.engines.size(); ++e) {
+    const string& name = options.engines[e];
+    string reason = CheckLimits(name, input);
+    if (!reason.empty()) {
+      cerr << "  skip " << name << " (" << reason << ")" << endl;
+      continue;
+    }
+    Engine engine = FindEngine(name);
+
+    for (int i = 0; i < options.warmup; ++i)
+      engine(input);
+
+    vector<Sample> samples;
+    for (int i = 0; i < options.repetitions; ++i)
+      samples.push_back(engine(input));
+
+    // The cost model of the engine, kEngineNum if there is none
+    selector::Engine modeled = selector::EngineByName(
+        name == "auto" ? samples.back().engine : name);
+
+    Result result;
+    result.experiment = experiment;
+    result.dataset = dataset;
+    result.engine = name == "auto" ? "auto-" + string(samples.back().engine)
+                                   : name;
+    result.text_length = input.text.size();
+    result.pattern_count = input.patterns.size();
+    result.pattern_length = pattern_length;
+    result.alphabet_size = input.alphabet.size();
+    result.queries = input.queries;
+    result.matches = samples.back().matches;
+
+    for (int p = 0; p < selector::kPhaseNum; ++p) {
+      selector::Phase phase = static_cast<selector::Phase>(p);
+      result.phase = selector::kPhaseNames[p];
+      Average(samples, p == selector::kPreprocess ? &Sample::preprocess
+                                                  : &Sample::search, &result);
+      result.predicted_us = -1;
+      if (modeled != selector::kEngineNum) {
+        if (name != "auto")
+          result.predicted_us = cost_model.PredictPhase(modeled, phase,
+                                                        workload);
+        else
+          result.predicted_us = phase == selector::kSearch ?
+              cost_model.Predict(modeled, workload) : 0;
+      }
+      results.push_back(result);
+    }
+  }
+  return results;
+}
+
+// Keeps the characters inside the alphabet all the engines understand
+string Sanitize(string str) {
+  for (size_t i = 0; i < str.size(); ++i)
+    if (str[i] < kFirstCharacter || str[i] > kLastCharacter)
+      str[i] = ' ';
+  return str;
+}
+
+bool ReadText(const string& path, string* text) {
+  std::ifstream file(path.c_str());
+  if (!file)
+    return false;
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  *text = buffer.str();
+  while (!text->empty() && (*text)[text->size() - 1] == '\n')
+    text->erase(text->size() - 1);
+  *text = Sanitize(*text);
+  return true;
+}
+
+// Reads one pattern per line. Lines of the form "pattern,frequency" after
+// a "pattern,..." header (two_patterns.txt) are cut at the comma.
+bool ReadPatterns(const string& path, vector<string>* patterns) {
+  std::ifstream file(path.c_str());
+  if (!file)
+    return false;
+  string line;
+  bool csv = false;
+  for (bool first = true; std::getline(file, line); first = false) {
+    if (first && line.compare(0, 8, "pattern,") == 0) {
+      csv = true;
+      continue;
+    }
+    if (csv)
+      line = line.substr(0, line.rfind(','));
+    if (!line.empty())
+      patterns->push_back(Sanitize(line));
+  }
+  return true;
+}
+
+void WriteCsv(const vector<Result>& results, ostream& stream) {
+  stream << "experiment,dataset,engine,phase,text_length,pattern_count,"
+            "pattern_length,alphabet_size,queries,matches,min_us,mean_us,"
+            "p50_us,p90_us,p99_us,max_us,predicted_us";
+  if (counters::kEnabled)
+    for (int i = 0; i < counters::kCounterNum; ++i)
+      stream << ',' << counters::kCounterNames[i];
+  if (perf_events)
+    for (int i = 0; i < counters::kPerfEventNum; ++i)
+      stream << ',' << counters::kPerfEventNames[i];
+  stream << endl;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    stream << r.experiment << ',' << r.dataset << ',' << r.engine << ','
+           << r.phase << ',' << r.text_length << ',' << r.pattern_count << ','
+           << r.pattern_length << ',' << r.alphabet_size << ','
+           << r.queries << ',' << r.matches << ','
+           << r.time_us.min << ',' << r.time_us.mean << ','
+           << r.time_us.p50 << ',' << r.time_us.p90 << ','
+           << r.time_us.p99 << ',' << r.time_us.max << ',';
+    if (r.predicted_us >= 0)
+      stream << r.predicted_us;
+    if (counters::kEnabled)
+      for (int c = 0; c < counters::kCounterNum; ++c)
+        stream << ',' << r.software[c];
+    if (perf_events)
+      for (int c = 0; c < counters::kPerfEventNum; ++c)
+        stream << ',' << r.hardware[c];
+    stream << endl;
+  }
+}
+
+void WriteJson(const Options& options, const vector<Result>& results,
+               ostream& stream) {
+  stream << "{\n  \"warmup\": " << options.warmup
+         << ",\n  \"repetitions\": " << options.repetitions
+         << ",\n  \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    stream << (i ? "," : "") << "\n    {"
+           << "\"experiment\": \"" << r.experiment << "\", "
+           << "\"dataset\": \"" << r.dataset << "\", "
+           << "\"engine\": \"" << r.engine << "\", "
+           << "\"phase\": \"" << r.phase << "\", "
+           << "\"text_length\": " << r.text_length << ", "
+           << "\"pattern_count\": " << r.pattern_count << ", "
+           << "\"pattern_length\": " << r.pattern_length << ", "
+           << "\"alphabet_size\": " << r.alphabet_size << ", "
+           << "\"queries\": " << r.queries << ", "
+           << "\"matches\": " << r.matches << ", "
+           << "\"time_us\": {"
+           << "\"min\": " << r.time_us.min << ", "
+           << "\"mean\": " << r.time_us.mean << ", "
+           << "\"p50\": " << r.time_us.p50 << ", "
+           << "\"p90\": " << r.time_us.p90 << ", "
+           << "\"p99\": " << r.time_us.p99 << ", "
+           << "\"max\": " << r.time_us.max << "}";
+    if (r.predicted_us >= 0)
+      stream << ", \"predicted_us\": " << r.predicted_us;
+    if (counters::kEnabled) {
+      stream << ", \"counters\": {";
+      for (int c = 0; c < counters::kCounterNum; ++c)
+        stream << (c ? ", " : "") << '"' << counters::kCounterNames[c]
+               << "\": " << r.software[c];
+      stream << "}";
+    }
+    if (perf_events) {
+      stream << ", \"perf\": {";
+      for (int c = 0; c < counters::kPerfEventNum; ++c)
+        stream << (c ? ", " : "") << '"' << counters::kPerfEventNames[c]
+               << "\": " << r.hardware[c];
+      stream << "}";
+    }
+    stream << "}";
+  }
+  stream << "\n  ]\n}" << endl;
+}
+
+vector<string> SplitList(const string& list) {
+  vector<string> items;
+  std::stringstream stream(list);
+  string item;
+  while (std::getline(stream, item, ','))
+    if (!item.empty())
+      items.push_back(item);
+  return items;
+}
+
+vector<size_t> SplitNumbers(const string& list) {
+  vector<string> items = SplitList(list);
+  vector<size_t> numbers;
+  for (size_t i = 0; i < items.size(); ++i)
+    numbers.push_back(std::strtoul(items[i].c_str(), NULL, 10));
+  return numbers;
+}
+
+selector::Workload ToWorkload(const Result& result) {
+  selector::Workload workload;
+  workload.text_length = result.text_length;
+  workload.alphabet_size = result.alphabet_size;
+  workload.pattern_count = result.pattern_count;
+  workload.pattern_length = result.pattern_length;
+  workload.queries = result.queries;
+  return workload;
+}
+
+// Fits the cost model of every engine phase to the median times of one
+// execution of the phase. Fails if there are no times for some phase.
+bool Calibrate(const vector<Result>& results, selector::CostModel* model) {
+  for (int e = 0; e < selector::kEngineNum; ++e)
+    for (int p = 0; p < selector::kPhaseNum; ++p) {
+      selector::Engine engine = static_cast<selector::Engine>(e);
+      selector::Phase phase = static_cast<selector::Phase>(p);
+      vector<double> features;
+      vector<double> times_us;
+      for (size_t i = 0; i < results.size(); ++i)
+        if (results[i].engine == selector::kEngineNames[e] &&
+            results[i].phase == selector::kPhaseNames[p]) {
+          // Only the suffix tree is built once for all the queries
+          double executions =
+              engine == selector::kSuffixTree && phase == selector::kPreprocess
+              ? 1 : results[i].queries;
+          features.push_back(
+              selector::Feature(engine, phase, ToWorkload(results[i])));
+          times_us.push_back(results[i].time_us.p50 / executions);
+        }
+      if (features.empty()) {
+        cerr << "No times of " << selector::kEngineNames[e] << ' '
+             << selector::kPhaseNames[p] << " to calibrate with" << endl;
+        return false;
+      }
+      model->Fit(engine, phase, features, times_us);
+    }
+  return true;
+}
+
+void PrintUsage() {
+  cerr << "Usage: bench [--option=value ...]\n"
+          "  --data=DIR                data directory (../data)\n"
+          "  --datasets=LIST           dna,plain_text\n"
+          "  --engines=LIST            bm,ac,st (and auto; bm-fixed, "
+          "ac-fixed with FIXED=1)\n"
+          "  --experiments=LIST        pattern-length,pattern-count,"
+          "text-length\n"
+          "  --pattern-lengths=LIST    1,2,4,8,16,32,64,100\n"
+          "  --pattern-counts=LIST     1,2,5,10,20,50,100\n"
+          "  --fixed-text-length=N     100000\n"
+          "  --max-text-length=N       500000\n"
+          "  --text-steps=N            5\n"
+          "  --warmup=N                1\n"
+          "  --reps=N                  5\n"
+          "  --perf=on|off             hardware counters (off)\n"
+          "  --queries=N               searches per run (1)\n"
+          "  --profile=FILE            cost model for auto "
+          "(cost_profile.txt)\n"
+          "  --calibrate=FILE          fit the cost model, save it to FILE\n"
+          "  --format=csv|json         csv\n"
+          "  --output=FILE             standard output" << endl;
+}
+
+bool ParseOptions(int argc, char* argv[], Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    size_t eq = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || eq == string::npos)
+      return false;
+    string key = arg.substr(2, eq - 2);
+    string value = arg.substr(eq + 1);
+    if (key == "data") options->data_dir = value;
+    else if (key == "datasets") options->datasets = SplitList(value);
+    else if (key == "engines") options->engines = SplitList(value);
+    else if (key == "experiments") options->experiments = SplitList(value);
+    else if (key == "pattern-lengths")
+      options->pattern_lengths = SplitNumbers(value);
+    else if (key == "pattern-counts")
+      options->pattern_counts = SplitNumbers(value);
+    else if (key == "fixed-text-length")
+      options->fixed_text_length = std::strtoul(value.c_str(), NULL, 10);
+    else if (key == "max-text-length")
+      options->max_text_length = std::strtoul(value.c_str(), NULL, 10);
+    else if (key == "text-steps")
+      options->text_steps = std::strtoul(value.c_str(), NULL, 10);
+    else if (key == "warmup") options->warmup = std::atoi(value.c_str());
+    else if (key == "reps") options->repetitions = std::atoi(value.c_str());
+    else if (key == "perf") options->perf = value == "on";
+    else if (key == "queries")
+      options->queries = std::strtoul(value.c_str(), NULL, 10);
+    else if (key == "profile") options->profile = value;
+    else if (key == "calibrate") options->calibrate = value;
+    else if (key == "format") options->format = value;
+    else if (key == "output") options->output = value;
+    else
+      return false;
+  }
+  for (size_t i = 0; i < options->engines.size(); ++i)
+    if (!FindEngine(options->engines[i])) {
+      cerr << "Unknown engine " << options->engines[i] << endl;
+      return false;
+    }
+  // Calibration needs the times of all the engines of the cost model
+  if (!options->calibrate.empty())
+    for (int e = 0; e < selector::kEngineNum; ++e)
+      if (std::find(options->engines.begin(), options->engines.end(),
+                    selector::kEngineNames[e]) == options->engines.end()) {
+        cerr << "--calibrate needs the engines bm, ac and st" << endl;
+        return false;
+      }
+  return options->repetitions > 0 && options->warmup >= 0 &&
+         options->text_steps > 0 && options->queries > 0 &&
+         (options->format == "csv" || options->format == "json");
+}
+
+Input MakeInput(const string& text, const vector<string>& patterns,
+                size_t queries) {
+  Input input;
+  input.queries = queries;
+  input.text = text;
+  char* alphabet = extractalphabet(text.c_str());
+  input.alphabet = alphabet;
+  delete[] alphabet;
+  input.patterns = patterns;
+  return input;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 1;
+  }
+
+  counters::PerfEvents hardware_events;
+  if (options.perf) {
+    if (hardware_events.Open())
+      perf_events = &hardware_events;
+    else
+      cerr << "Hardware counters are not available, ignoring --perf" << endl;
+  }
+
+  // The profile is also used for predicted_us, but only "auto" needs it
+  if (!cost_model.Load(options.profile) &&
+      std::find(options.engines.begin(), options.engines.end(), "auto") !=
+          options.engines.end())
+    cerr << "Cannot read the profile " << options.profile
+         << ", using the default cost model" << endl;
+
+  vector<Result> results;
+  for (size_t d = 0; d < options.datasets.size(); ++d) {
+    const string& dataset = options.datasets[d];
+    const string dir = options.data_dir + "/" + dataset + "/";
+    string text;
+    vector<string> patterns;        // patterns of growing length
+    vector<string> fixed_patterns;  // a frequent and a rare pattern
+    if (!ReadText(dir + "text.txt", &text) ||
+        !ReadPatterns(dir + "100_patterns.txt", &patterns) ||
+        !ReadPatterns(dir + "two_patterns.txt", &fixed_patterns)) {
+      cerr << "Cannot read the data set in " << dir << endl;
+      return 1;
+    }
+    const string fixed_text = text.substr(0, options.fixed_text_length);
+
+    for (size_t x = 0; x < options.experiments.size(); ++x) {
+      const string& experiment = options.experiments[x];
+      cerr << dataset << ": " << experiment << endl;
+      vector<Input> inputs;
+
+      if (experiment == "pattern-length") {
+        for (size_t i = 0; i < options.pattern_lengths.size(); ++i)
+          for (size_t p = 0; p < patterns.size(); ++p)
+            if (patterns[p].size() == options.pattern_lengths[i]) {
+              inputs.push_back(MakeInput(fixed_text,
+                                         vector<string>(1, patterns[p]),
+                                         options.queries));
+              break;
+            }
+      } else if (experiment == "pattern-count") {
+        for (size_t i = 0; i < options.pattern_counts.size(); ++i) {
+          size_t count = std::min(options.pattern_counts[i], patterns.size());
+          inputs.push_back(MakeInput(fixed_text, vector<string>(
+              patterns.begin(), patterns.begin() + count), options.queries));
+        }
+      } else if (experiment == "text-length") {
+        size_t max_length = std::min(options.max_text_length, text.size());
+        for (size_t step = 1; step <= options.text_steps; ++step) {
+          string prefix = text.substr(0, max_length * step / options.text_steps);
+          for (size_t p = 0; p < fixed_patterns.size(); ++p)
+            inputs.push_back(MakeInput(prefix,
+                                       vector<string>(1, fixed_patterns[p]),
+                                       options.queries));
+        }
+      } else {
+        cerr << "Unknown experiment " << experiment << endl;
+        return 1;
+      }
+
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        vector<Result> measured = Measure(options, experiment, dataset,
+                                          inputs[i]);
+        results.insert(results.end(), measured.begin(), measured.end());
+      }
+    }
+  }
+
+  if (!options.calibrate.empty()) {
+    selector::CostModel calibrated;
+    if (!Calibrate(results, &calibrated)) {
+      cerr << "The cost model was not calibrated" << endl;
+      return 1;
+    }
+    if (!calibrated.Save(options.calibrate)) {
+      cerr << "Cannot write to " << options.calibrate << endl;
+      return 1;
+    }
+    cerr << "Cost model saved to " << options.calibrate << endl;
+  }
+
+  std::ofstream file;
+  if (!options.output.empty()) {
+    file.open(options.output.c_str());
+    if (!file) {
+      cerr << "Cannot write to " << options.output << endl;
+      return 1;
+    }
+  }
+  ostream& stream = options.output.empty() ? cout : file;
+  if (options.format == "json")
+    WriteJson(options, results, stream);
+  else
+    WriteCsv(results, stream);
+
+  return 0;
+}
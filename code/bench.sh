@@ -0,0 +1,13 @@
+#!/bin/bash
+# Set CXXFLAGS=-DPM_COUNTERS to build the engines with their counters
+# Set FIXED=1 to build the compile-time matchers (engines bm-fixed, ac-fixed)
+if [ "$FIXED" = 1 ]; then
+  FIXED_SOURCES="-DPM_FIXED fixed/data_patterns.cc"
+fi
+g++ -std=c++17 -O2 $CXXFLAGS -DAC_NO_MAIN -DBM_NO_MAIN bench.cc \
+    suffixtree/suffix_tree.cc ../ahocorasick/ac.cpp \
+    BM/BoyreMoore/BoyreMoore/BoyreMoore.cpp \
+    counters/counters.cc counters/perf_events.cc \
+    selector/engine_selector.cc $FIXED_SOURCES -o bench
+./bench "$@"
+rm bench
@@ -0,0 +1,20 @@
+/******************************************************************************
+ * Hot-path instrumentation counters
+ ******************************************************************************/
+#include "counters.h"
+
+namespace counters {
+
+unsigned long long values[kCounterNum] = {0};
+
+const char* const kCounterNames[kCounterNum] = {
+  "bm_comparisons",
+  "bm_shifts",
+  "ac_failure_hops",
+  "st_suffix_link_traversals",
+  "st_edge_splits",
+  "st_normalize_iterations",
+  "st_match_node_visits",
+};
+
+}  // namespace counters
@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Hot-path instrumentation counters
+ *
+ * The engines call COUNT(kSomething) in their inner loops. The macro expands
+ * to nothing unless the program is compiled with -DPM_COUNTERS, so the
+ * counters cost nothing in a normal build. The engines alone need
+ * counters.cc only when the counters are enabled; programs that read
+ * values[] or kCounterNames[] (like bench.cc) always have to link it.
+ ******************************************************************************/
+#ifndef COUNTERS_H_
+#define COUNTERS_H_
+
+namespace counters {
+
+enum Counter {
+  kBmComparisons,           // character comparisons in bmsearch()
+  kBmShifts,                // pattern shifts in bmsearch()
+  kAcFailureHops,           // failure links followed in findNextState()
+  kStSuffixLinkTraversals,  // suffix links followed in SuffixTree::Build()
+  kStEdgeSplits,            // edges split in SuffixTree::Build()
+  kStNormalizeIterations,   // loop iterations of NormalizeActivePoint()
+  kStMatchNodeVisits,       // explicit nodes visited in SuffixTree::Match()
+  kCounterNum
+};
+
+#ifdef PM_COUNTERS
+const bool kEnabled = true;
+#else
+const bool kEnabled = false;
+#endif
+
+extern unsigned long long values[kCounterNum];
+extern const char* const kCounterNames[kCounterNum];
+
+}  // namespace counters
+
+#ifdef PM_COUNTERS
+#define COUNT(counter) (++counters::values[counters::counter])
+#else
+#define COUNT(counter) ((void)0)
+#endif
+
+#endif  // COUNTERS_H_
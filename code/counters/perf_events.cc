@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Hardware event counters based on perf_event_open(2)
+ ******************************************************************************/
+#include "perf_events.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace counters {
+
+const char* const kPerfEventNames[kPerfEventNum] = {
+  "cycles",
+  "cache_misses",
+  "branch_misses",
+};
+
+PerfEvents::PerfEvents() {
+  for (int i = 0; i < kPerfEventNum; ++i)
+    fds[i] = -1;
+}
+
+PerfEvents::~PerfEvents() {
+  Close();
+}
+
+#ifdef __linux__
+
+namespace {
+
+const unsigned long long kEventConfigs[kPerfEventNum] = {
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_CACHE_MISSES,
+  PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int OpenEvent(unsigned long long config, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof attr);
+  attr.size = sizeof attr;
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd == -1;   // the whole group starts with the leader
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+}  // namespace
+
+bool PerfEvents::Open() {
+  Close();
+  for (int i = 0; i < kPerfEventNum; ++i) {
+    fds[i] = OpenEvent(kEventConfigs[i], fds[kCycles]);
+    if (fds[i] < 0) {
+      Close();
+      return false;
+    }
+  }
+  return true;
+}
+
+void PerfEvents::Start() {
+  if (fds[kCycles] < 0)
+    return;
+  ioctl(fds[kCycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds[kCycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfEvents::Stop(unsigned long long counts[kPerfEventNum]) {
+  for (int i = 0; i < kPerfEventNum; ++i)
+    counts[i] = 0;
+  if (fds[kCycles] < 0)
+    return;
+  ioctl(fds[kCycles], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+  // PERF_FORMAT_GROUP layout: the number of events, then their values
+  unsigned long long buffer[1 + kPerfEventNum];
+  ssize_t size = read(fds[kCycles], buffer, sizeof buffer);
+  if (size != static_cast<ssize_t>(sizeof buffer))
+    return;
+  for (int i = 0; i < kPerfEventNum; ++i)
+    counts[i] = buffer[1 + i];
+}
+
+void PerfEvents::Close() {
+  for (int i = kPerfEventNum - 1; i >= 0; --i) {
+    if (fds[i] >= 0)
+      close(fds[i]);
+    fds[i] = -1;
+  }
+}
+
+#else  // __linux__
+
+bool PerfEvents::Open() {
+  return false;
+}
+
+void PerfEvents::Start() {}
+
+void PerfEvents::Stop(unsigned long long counts[kPerfEventNum]) {
+  for (int i = 0; i < kPerfEventNum; ++i)
+    counts[i] = 0;
+}
+
+void PerfEvents::Close() {}
+
+#endif  // __linux__
+
+}  // namespace counters
@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Hardware event counters based on perf_event_open(2)
+ *
+ * Counts CPU cycles, cache misses and branch misses of the calling thread
+ * (user space only) between Start() and Stop(). On other systems, or when
+ * the kernel refuses access (see /proc/sys/kernel/perf_event_paranoid),
+ * Open() returns false and the counters are not available.
+ ******************************************************************************/
+#ifndef PERF_EVENTS_H_
+#define PERF_EVENTS_H_
+
+namespace counters {
+
+enum PerfEvent {
+  kCycles,
+  kCacheMisses,
+  kBranchMisses,
+  kPerfEventNum
+};
+
+extern const char* const kPerfEventNames[kPerfEventNum];
+
+class PerfEvents {
+ public:
+  PerfEvents();
+  ~PerfEvents();
+
+  bool Open();
+  void Start();
+  // Stops counting and stores the counts since the last Start()
+  void Stop(unsigned long long counts[kPerfEventNum]);
+
+ private:
+  int fds[kPerfEventNum];   // fds[kCycles] is the group leader
+
+  PerfEvents(const PerfEvents&);
+  void operator=(const PerfEvents&);
+  void Close();
+};
+
+}  // namespace counters
+
+#endif  // PERF_EVENTS_H_
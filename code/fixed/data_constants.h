@@ -0,0 +1,82 @@
+/******************************************************************************
+ * The patterns of data/ as constants
+ *
+ * The compile-time matchers take their patterns as template arguments, so
+ * the patterns they are compiled for are copied here from the data files:
+ * the two patterns of every two_patterns.txt, and from every
+ * 100_patterns.txt the first 10 patterns and those of length 16, 32, 64
+ * and 100. Line i of 100_patterns.txt is i characters long. test.cc checks
+ * every constant against its line of the data file.
+ ******************************************************************************/
+#ifndef DATA_CONSTANTS_H_
+#define DATA_CONSTANTS_H_
+
+namespace fixed {
+namespace data {
+
+// data/dna/two_patterns.txt
+constexpr char kDnaFrequent[] = "AAC";
+constexpr char kDnaRare[] = "GGCCAATCT";
+
+// data/plain_text/two_patterns.txt
+constexpr char kTextFrequent[] = "the";
+constexpr char kTextRare[] = "yellow";
+
+// Lines of data/dna/100_patterns.txt
+constexpr char kDna1[] = "A";
+constexpr char kDna2[] = "CT";
+constexpr char kDna3[] = "AGC";
+constexpr char kDna4[] = "TATA";
+constexpr char kDna5[] = "CCAAT";
+constexpr char kDna6[] = "TATAAA";
+constexpr char kDna7[] = "AAGGTTG";
+constexpr char kDna8[] = "CGAGAATA";
+constexpr char kDna9[] = "GGCCAATCT";
+constexpr char kDna10[] = "GAGTGATGTC";
+constexpr char kDna16[] = "CAAGGAGCCGCCCGTA";
+constexpr char kDna32[] = "ACCCATTATCGAGTTGGGATCTGGGCGTTGTA";
+constexpr char kDna64[] =
+    "TTAGAATGACTGGTCCAGGATGAAACCTAATTTGAGTGGACATCCATGGATGAGAAATGCGGAT";
+constexpr char kDna100[] =
+    "TCTGGGTAATGGAAGATGCCCTGCAAAGACCTCTCCGACTTTGCGGGGAAAGATAGACTGTGTTGGAATTCCG"
+    "GCTTGCCCTGACAGGATCGACATCGAA";
+
+// Lines of data/plain_text/100_patterns.txt
+constexpr char kText1[] = "a";
+constexpr char kText2[] = " t";
+constexpr char kText3[] = " I,";
+constexpr char kText4[] = "is c";
+constexpr char kText5[] = "it an";
+constexpr char kText6[] = ", s'I;";
+constexpr char kText7[] = " the br";
+constexpr char kText8[] = "s could ";
+constexpr char kText9[] = "hat was l";
+constexpr char kText10[] = "e of them ";
+constexpr char kText16[] = "raight; so she s";
+constexpr char kText32[] = "er anybody sees us do it or not.";
+constexpr char kText64[] =
+    "to myself, spos'n he can't fix that leg just in three shakes of ";
+constexpr char kText100[] =
+    " and is always seeing what time it is, and so there ain't nothing more to"
+    " write about, and I am rott";
+
+// The patterns of every file, in the order of their lines
+constexpr const char* kDnaTwoPatterns[] = {
+  kDnaFrequent, kDnaRare,
+};
+constexpr const char* kTextTwoPatterns[] = {
+  kTextFrequent, kTextRare,
+};
+constexpr const char* kDnaPatterns[] = {
+  kDna1, kDna2, kDna3, kDna4, kDna5, kDna6, kDna7, kDna8, kDna9, kDna10,
+  kDna16, kDna32, kDna64, kDna100,
+};
+constexpr const char* kTextPatterns[] = {
+  kText1, kText2, kText3, kText4, kText5, kText6, kText7, kText8, kText9,
+  kText10, kText16, kText32, kText64, kText100,
+};
+
+}  // namespace data
+}  // namespace fixed
+
+#endif  // DATA_CONSTANTS_H_
@@ -0,0 +1,130 @@
+/******************************************************************************
+ * Compile-time matchers for the patterns of data/
+ ******************************************************************************/
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "data_constants.h"
+#include "data_patterns.h"
+#include "fixed_matchers.h"
+
+using std::string;
+using std::vector;
+
+namespace fixed {
+
+namespace {
+
+using namespace data;
+
+struct BoyerMooreMatcher {
+  const char* pattern;
+  CountFunction count;
+};
+
+struct AhoCorasickMatcher {
+  const char* const* patterns;
+  size_t pattern_count;
+  CountFunction count;
+};
+
+// The matchers of List[Index] and of the first Count patterns of List;
+// the keys point into List, so every pattern is spelled out only once.
+template <const char* const* List, size_t Index>
+BoyerMooreMatcher BoyerMooreOf() {
+  return {List[Index], BoyerMoore<List[Index]>::Count};
+}
+
+template <const char* const* List, size_t... Indices>
+CountFunction AhoCorasickCount(std::index_sequence<Indices...>) {
+  return AhoCorasick<List[Indices]...>::Count;
+}
+
+template <const char* const* List, size_t Index>
+AhoCorasickMatcher AhoCorasickOf() {
+  return {List + Index, 1, AhoCorasick<List[Index]>::Count};
+}
+
+template <const char* const* List, size_t Count>
+AhoCorasickMatcher AhoCorasickOfFirst() {
+  return {List, Count,
+          AhoCorasickCount<List>(std::make_index_sequence<Count>())};
+}
+
+// The matchers of every pattern of List
+template <const char* const* List, size_t... Indices>
+void AddBoyerMoore(std::index_sequence<Indices...>,
+                   vector<BoyerMooreMatcher>* matchers) {
+  matchers->insert(matchers->end(), {BoyerMooreOf<List, Indices>()...});
+}
+
+template <const char* const* List, size_t... Indices>
+void AddAhoCorasick(std::index_sequence<Indices...>,
+                    vector<AhoCorasickMatcher>* matchers) {
+  matchers->insert(matchers->end(), {AhoCorasickOf<List, Indices>()...});
+}
+
+vector<BoyerMooreMatcher> MakeBoyerMoore() {
+  vector<BoyerMooreMatcher> matchers;
+  AddBoyerMoore<kDnaTwoPatterns>(
+      std::make_index_sequence<std::size(kDnaTwoPatterns)>(), &matchers);
+  AddBoyerMoore<kTextTwoPatterns>(
+      std::make_index_sequence<std::size(kTextTwoPatterns)>(), &matchers);
+  AddBoyerMoore<kDnaPatterns>(
+      std::make_index_sequence<std::size(kDnaPatterns)>(), &matchers);
+  AddBoyerMoore<kTextPatterns>(
+      std::make_index_sequence<std::size(kTextPatterns)>(), &matchers);
+  return matchers;
+}
+
+// Every pattern alone, and the first 2, 5 and 10 patterns of every
+// 100_patterns.txt
+vector<AhoCorasickMatcher> MakeAhoCorasick() {
+  vector<AhoCorasickMatcher> matchers;
+  AddAhoCorasick<kDnaTwoPatterns>(
+      std::make_index_sequence<std::size(kDnaTwoPatterns)>(), &matchers);
+  AddAhoCorasick<kTextTwoPatterns>(
+      std::make_index_sequence<std::size(kTextTwoPatterns)>(), &matchers);
+  AddAhoCorasick<kDnaPatterns>(
+      std::make_index_sequence<std::size(kDnaPatterns)>(), &matchers);
+  AddAhoCorasick<kTextPatterns>(
+      std::make_index_sequence<std::size(kTextPatterns)>(), &matchers);
+  matchers.insert(matchers.end(), {
+    AhoCorasickOfFirst<kDnaPatterns, 2>(),
+    AhoCorasickOfFirst<kDnaPatterns, 5>(),
+    AhoCorasickOfFirst<kDnaPatterns, 10>(),
+    AhoCorasickOfFirst<kTextPatterns, 2>(),
+    AhoCorasickOfFirst<kTextPatterns, 5>(),
+    AhoCorasickOfFirst<kTextPatterns, 10>(),
+  });
+  return matchers;
+}
+
+const vector<BoyerMooreMatcher> kBoyerMoore = MakeBoyerMoore();
+const vector<AhoCorasickMatcher> kAhoCorasick = MakeAhoCorasick();
+
+}  // namespace
+
+CountFunction FindBoyerMoore(const string& pattern) {
+  for (const BoyerMooreMatcher& matcher : kBoyerMoore)
+    if (pattern == matcher.pattern)
+      return matcher.count;
+  return NULL;
+}
+
+CountFunction FindAhoCorasick(const vector<string>& patterns) {
+  for (const AhoCorasickMatcher& matcher : kAhoCorasick) {
+    if (patterns.size() != matcher.pattern_count)
+      continue;
+    size_t i = 0;
+    while (i < patterns.size() && patterns[i] == matcher.patterns[i])
+      ++i;
+    if (i == patterns.size())
+      return matcher.count;
+  }
+  return NULL;
+}
+
+}  // namespace fixed
@@ -0,0 +1,27 @@
+/******************************************************************************
+ * Compile-time matchers for the patterns of data/
+ *
+ * Lets the benchmark compare fixed::BoyerMoore and fixed::AhoCorasick with
+ * their run time counterparts on a representative subset of the inputs.
+ * Compiled in are the patterns of data_constants.h one by one, and for
+ * Aho-Corasick also the first 2, 5 and 10 patterns of every
+ * 100_patterns.txt as sets. Other inputs are skipped by the benchmark.
+ ******************************************************************************/
+#ifndef DATA_PATTERNS_H_
+#define DATA_PATTERNS_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace fixed {
+
+typedef long (*CountFunction) (const char* text, size_t length);
+
+// Return NULL if no matcher was compiled in for the pattern(s)
+CountFunction FindBoyerMoore(const std::string& pattern);
+CountFunction FindAhoCorasick(const std::vector<std::string>& patterns);
+
+}  // namespace fixed
+
+#endif  // DATA_PATTERNS_H_
@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Compile-time specialized matchers for fixed patterns (C++17)
+ *
+ * When a pattern is known at build time its tables don't have to be built at
+ * run time. The patterns are passed as template arguments, so they have to
+ * be constexpr character arrays with static storage:
+ *
+ *   constexpr char kPattern[] = "GGCCAATCT";
+ *   long occurrences = fixed::BoyerMoore<kPattern>::Count(text, length);
+ *
+ *   constexpr char kShe[] = "she";
+ *   constexpr char kHers[] = "hers";
+ *   long occurrences = fixed::AhoCorasick<kShe, kHers>::Count(text, length);
+ *
+ * BoyerMoore computes the same bad character table as preprocess() in
+ * BoyreMoore.cpp, already turned into shifts, and compares the window with
+ * a fully unrolled sequence of comparisons against the constant pattern.
+ * AhoCorasick builds the machine of buildMatchingMachine() in ac.cpp and
+ * folds the failure function into a complete transition table, so searching
+ * takes one transition per text character. The transition table has a
+ * column per character of the patterns plus one shared by all the other
+ * characters, which keeps it small and quick to compile for large pattern
+ * sets. Both tables are constexpr static members and end up in read-only
+ * data.
+ ******************************************************************************/
+#ifndef FIXED_MATCHERS_H_
+#define FIXED_MATCHERS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace fixed {
+
+const size_t kAlphabetSize = 256;   // tables are indexed by unsigned char
+
+constexpr size_t Length(const char* str) {
+  size_t length = 0;
+  while (str[length])
+    ++length;
+  return length;
+}
+
+// The columns of the Aho-Corasick transition table: one per character of
+// the patterns and one for all the other characters. of[c] is the column
+// of c, count the number of columns.
+struct CharacterClasses {
+  uint16_t of[kAlphabetSize] = {};
+  size_t count = 1;
+};
+
+template <typename... Strings>
+constexpr CharacterClasses Classify(Strings... strs) {
+  CharacterClasses classes;
+  const char* const list[] = {strs...};
+  for (const char* str : list)
+    for (size_t i = 0; str[i]; ++i) {
+      unsigned char c = str[i];
+      if (classes.of[c] == 0)
+        classes.of[c] = classes.count++;
+    }
+  return classes;
+}
+
+template <const char* Pattern>
+class BoyerMoore {
+ public:
+  static constexpr size_t kLength = Length(Pattern);
+  static_assert(kLength > 0, "the pattern must not be empty");
+  static_assert(kLength < 256, "shifts are stored in unsigned chars");
+
+  // Returns the number of occurrences of Pattern in text[0..length-1]
+  static long Count(const char* text, size_t length) {
+    long occurrences = 0;
+    size_t l = 0;
+    while (l + kLength <= length) {
+      int j = Mismatch(text + l, std::make_index_sequence<kLength>());
+      if (j < 0) {
+        ++occurrences;
+        ++l;
+      } else {
+        l += kTable.shift[j][static_cast<unsigned char>(text[l + j])];
+      }
+    }
+    return occurrences;
+  }
+
+ private:
+  // shift[j][c] tells how far to move the pattern if it mismatches the text
+  // character c at position j: up to the rightmost c in Pattern[0..j-1].
+  struct Table {
+    unsigned char shift[kLength][kAlphabetSize] = {};
+  };
+
+  static constexpr Table MakeTable() {
+    Table table;
+    for (size_t j = 0; j < kLength; ++j) {
+      for (size_t c = 0; c < kAlphabetSize; ++c)
+        table.shift[j][c] = j + 1;
+      for (size_t i = 0; i < j; ++i)
+        table.shift[j][static_cast<unsigned char>(Pattern[i])] = j - i;
+    }
+    return table;
+  }
+
+  static constexpr Table kTable = MakeTable();
+
+  // Compares the window with Pattern from right to left and returns the
+  // position of the rightmost mismatch, -1 if there is none. The fold
+  // expands to one comparison per pattern character and stops at the first
+  // mismatch.
+  template <size_t... I>
+  static int Mismatch(const char* window, std::index_sequence<I...>) {
+    int j = -1;
+    ((window[kLength - 1 - I] == Pattern[kLength - 1 - I] ||
+      (j = kLength - 1 - I, false)) && ...);
+    return j;
+  }
+};
+
+template <const char*... Patterns>
+class AhoCorasick {
+ public:
+  static_assert(sizeof...(Patterns) > 0, "at least one pattern is needed");
+  static constexpr size_t kStates = 1 + (Length(Patterns) + ...);
+  static constexpr CharacterClasses kClasses = Classify(Patterns...);
+
+  // Returns the number of occurrences of all Patterns in text[0..length-1]
+  static long Count(const char* text, size_t length) {
+    long occurrences = 0;
+    State state = 0;
+    for (size_t i = 0; i < length; ++i) {
+      unsigned char c = text[i];
+      state = kMachine.next[state][kClasses.of[c]];
+      occurrences += kMachine.matches[state];
+    }
+    return occurrences;
+  }
+
+ private:
+  typedef typename std::conditional<(kStates <= UINT16_MAX), uint16_t,
+                                    uint32_t>::type State;
+
+  // next is the goto function completed with the failure function,
+  // matches[s] is the number of patterns that end when entering state s.
+  struct Machine {
+    State next[kStates][kClasses.count] = {};
+    uint16_t matches[kStates] = {};
+  };
+
+  static constexpr Machine MakeMachine() {
+    Machine machine;
+    const char* const patterns[] = {Patterns...};
+
+    // The trie; 0 means no edge as the root is nobody's child
+    State states = 1;
+    for (const char* pattern : patterns) {
+      State current = 0;
+      for (size_t i = 0; pattern[i]; ++i) {
+        size_t c = kClasses.of[static_cast<unsigned char>(pattern[i])];
+        if (machine.next[current][c] == 0)
+          machine.next[current][c] = states++;
+        current = machine.next[current][c];
+      }
+      ++machine.matches[current];
+    }
+
+    // Failure function in breadth first order; missing edges of a state
+    // are taken from its failure state, which is closer to the root and
+    // therefore already complete.
+    State failure[kStates] = {};
+    State queue[kStates] = {};
+    size_t head = 0, tail = 0;
+    for (size_t c = 0; c < kClasses.count; ++c)
+      if (machine.next[0][c] != 0)
+        queue[tail++] = machine.next[0][c];
+    while (head < tail) {
+      State state = queue[head++];
+      for (size_t c = 0; c < kClasses.count; ++c) {
+        State child = machine.next[state][c];
+        if (child != 0) {
+          failure[child] = machine.next[failure[state]][c];
+          machine.matches[child] += machine.matches[failure[child]];
+          queue[tail++] = child;
+        } else {
+          machine.next[state][c] = machine.next[failure[state]][c];
+        }
+      }
+    }
+    return machine;
+  }
+
+  static constexpr Machine kMachine = MakeMachine();
+};
+
+}  // namespace fixed
+
+#endif  // FIXED_MATCHERS_H_
@@ -0,0 +1,313 @@
+/******************************************************************************
+ * Adaptive engine selection
+ ******************************************************************************/
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "engine_selector.h"
+#include "../../ahocorasick/ac.h"
+#include "../BM/BoyreMoore/BoyreMoore/BoyreMoore.h"
+#include "../suffixtree/suffix_tree.h"
+
+using std::string;
+using std::vector;
+
+namespace selector {
+
+const char* const kEngineNames[kEngineNum] = {"bm", "ac", "st"};
+const char* const kPhaseNames[kPhaseNum] = {"preprocess", "search"};
+
+namespace {
+
+// Coefficients measured on the development machine with the default
+// benchmark configuration, in microseconds
+const double kDefaultFixedUs[kEngineNum][kPhaseNum] = {
+  {14.0, 0.0},      // bm
+  {1.1, 733.0},     // ac
+  {0.0, 7.3},       // st
+};
+const double kDefaultUnitUs[kEngineNum][kPhaseNum] = {
+  {0.0023, 0.0197},   // bm
+  {0.182, 0.0124},    // ac
+  {3.58, 0.0535},     // st
+};
+
+int FindName(const char* const names[], int count, const string& name) {
+  for (int i = 0; i < count; ++i)
+    if (name == names[i])
+      return i;
+  return -1;
+}
+
+}  // namespace
+
+Engine EngineByName(const string& name) {
+  int engine = FindName(kEngineNames, kEngineNum, name);
+  return engine < 0 ? kEngineNum : static_cast<Engine>(engine);
+}
+
+Workload Describe(const string& text, const vector<string>& patterns,
+                  size_t queries) {
+  Workload workload;
+  workload.text_length = text.size();
+  workload.alphabet_size = std::set<char>(text.begin(), text.end()).size();
+  workload.pattern_count = patterns.size();
+  workload.printable = Printable(text);
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    workload.pattern_length += patterns[i].size();
+    workload.printable = workload.printable && Printable(patterns[i]);
+  }
+  workload.queries = queries;
+  return workload;
+}
+
+// Boyer-Moore builds a k x |alphabet| table per pattern, and shifts every
+// pattern along the text by at most min(k, |alphabet|) characters at a time.
+// Aho-Corasick builds a machine with one state per pattern character and
+// makes one transition per text character. The suffix tree is built in
+// linear time of the text and matches a pattern in linear time of it.
+double Feature(Engine engine, Phase phase, const Workload& workload) {
+  double text = workload.text_length;
+  double patterns = workload.pattern_length;
+  double alphabet = std::max<size_t>(workload.alphabet_size, 1);
+  switch (engine) {
+    case kBoyerMoore:
+      if (phase == kPreprocess)
+        return patterns * alphabet;
+      if (workload.pattern_count == 0)
+        return 0;
+      return workload.pattern_count * text /
+          std::min(std::max(patterns / workload.pattern_count, 1.0), alphabet);
+    case kAhoCorasick:
+      return phase == kPreprocess ? patterns : text;
+    case kSuffixTree:
+      return phase == kPreprocess ? text : patterns;
+    default:
+      return 0;
+  }
+}
+
+bool Printable(const string& str) {
+  for (size_t i = 0; i < str.size(); ++i)
+    if (str[i] < ' ' || str[i] > '~')
+      return false;
+  return true;
+}
+
+// Aho-Corasick and the suffix tree index their tables by character - ' '
+bool Supports(Engine engine, const Workload& workload) {
+  switch (engine) {
+    case kBoyerMoore:
+      return true;
+    case kAhoCorasick:
+      return workload.printable &&
+             workload.pattern_count <= static_cast<size_t>(MAXW) &&
+             workload.pattern_length + 1 <= static_cast<size_t>(MAXS);
+    default:
+      return workload.printable;
+  }
+}
+
+CostModel::CostModel() {
+  for (int e = 0; e < kEngineNum; ++e)
+    for (int p = 0; p < kPhaseNum; ++p) {
+      fixed_us[e][p] = kDefaultFixedUs[e][p];
+      unit_us[e][p] = kDefaultUnitUs[e][p];
+    }
+}
+
+// The model is changed only if the whole profile could be read
+bool CostModel::Load(const string& path) {
+  std::ifstream file(path.c_str());
+  if (!file)
+    return false;
+  double fixed_read[kEngineNum][kPhaseNum];
+  double unit_read[kEngineNum][kPhaseNum];
+  std::copy(&fixed_us[0][0], &fixed_us[0][0] + kEngineNum * kPhaseNum,
+            &fixed_read[0][0]);
+  std::copy(&unit_us[0][0], &unit_us[0][0] + kEngineNum * kPhaseNum,
+            &unit_read[0][0]);
+  string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream stream(line);
+    string engine_name, phase_name;
+    double fixed, unit;
+    if (!(stream >> engine_name >> phase_name >> fixed >> unit))
+      return false;
+    int engine = FindName(kEngineNames, kEngineNum, engine_name);
+    int phase = FindName(kPhaseNames, kPhaseNum, phase_name);
+    if (engine < 0 || phase < 0)
+      return false;
+    fixed_read[engine][phase] = fixed;
+    unit_read[engine][phase] = unit;
+  }
+  std::copy(&fixed_read[0][0], &fixed_read[0][0] + kEngineNum * kPhaseNum,
+            &fixed_us[0][0]);
+  std::copy(&unit_read[0][0], &unit_read[0][0] + kEngineNum * kPhaseNum,
+            &unit_us[0][0]);
+  return true;
+}
+
+bool CostModel::Save(const string& path) const {
+  std::ofstream file(path.c_str());
+  if (!file)
+    return false;
+  file << "# engine phase fixed_us unit_us" << std::endl;
+  for (int e = 0; e < kEngineNum; ++e)
+    for (int p = 0; p < kPhaseNum; ++p)
+      file << kEngineNames[e] << ' ' << kPhaseNames[p] << ' '
+           << fixed_us[e][p] << ' ' << unit_us[e][p] << std::endl;
+  return static_cast<bool>(file);
+}
+
+void CostModel::Fit(Engine engine, Phase phase, const vector<double>& features,
+                    const vector<double>& times_us) {
+  size_t n = std::min(features.size(), times_us.size());
+  if (n == 0)
+    return;
+  double sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sx += features[i];
+    sy += times_us[i];
+    sxx += features[i] * features[i];
+    sxy += features[i] * times_us[i];
+  }
+
+  double fixed = 0;
+  double unit = 0;
+  double variance = n * sxx - sx * sx;
+  if (variance > 0) {
+    unit = (n * sxy - sx * sy) / variance;
+    fixed = (sy - unit * sx) / n;
+  }
+  // Neither a negative fixed cost nor a negative slope makes sense, fall
+  // back to the fit through the origin or to a constant.
+  if (fixed < 0 || unit < 0 || variance <= 0) {
+    fixed = 0;
+    unit = sxx > 0 ? sxy / sxx : 0;
+    if (unit <= 0) {
+      fixed = sy / n;
+      unit = 0;
+    }
+  }
+  fixed_us[engine][phase] = fixed;
+  unit_us[engine][phase] = unit;
+}
+
+double CostModel::PredictPhase(Engine engine, Phase phase,
+                               const Workload& workload,
+                               bool text_preprocessed) const {
+  double cost = fixed_us[engine][phase] +
+      unit_us[engine][phase] * Feature(engine, phase, workload);
+  // Only the suffix tree preprocesses the text, and can reuse it
+  if (engine == kSuffixTree && phase == kPreprocess)
+    return text_preprocessed ? 0 : cost;
+  return workload.queries * cost;
+}
+
+double CostModel::Predict(Engine engine, const Workload& workload,
+                          bool text_preprocessed) const {
+  return PredictPhase(engine, kPreprocess, workload, text_preprocessed) +
+         PredictPhase(engine, kSearch, workload, text_preprocessed);
+}
+
+Engine CostModel::Choose(const Workload& workload,
+                         bool text_preprocessed) const {
+  Engine best = kBoyerMoore;
+  double best_cost = Predict(kBoyerMoore, workload, text_preprocessed);
+  for (int e = 0; e < kEngineNum; ++e) {
+    Engine engine = static_cast<Engine>(e);
+    if (!Supports(engine, workload))
+      continue;
+    double cost = Predict(engine, workload, text_preprocessed);
+    if (cost < best_cost) {
+      best = engine;
+      best_cost = cost;
+    }
+  }
+  return best;
+}
+
+Searcher::Searcher(const CostModel& model, const string& text, size_t queries)
+    : model_(model)
+    , text_(text)
+    , text_printable_(Printable(text))
+    , queries_left_(std::max<size_t>(queries, 1))
+    , tree_(NULL)
+    , last_engine_(kSuffixTree)
+{
+  char* alphabet = extractalphabet(text.c_str());
+  alphabet_ = alphabet;
+  delete[] alphabet;
+}
+
+Searcher::~Searcher() {
+  delete tree_;
+}
+
+long Searcher::Count(const vector<string>& patterns) {
+  Workload workload;
+  workload.text_length = text_.size();
+  workload.alphabet_size = alphabet_.size();
+  workload.pattern_count = patterns.size();
+  workload.printable = text_printable_;
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    workload.pattern_length += patterns[i].size();
+    workload.printable = workload.printable && Printable(patterns[i]);
+  }
+  workload.queries = queries_left_;
+  if (queries_left_ > 1)
+    --queries_left_;
+
+  last_engine_ = model_.Choose(workload, tree_ != NULL);
+  long occurrences = 0;
+  switch (last_engine_) {
+    case kBoyerMoore:
+      for (size_t i = 0; i < patterns.size(); ++i) {
+        if (patterns[i].empty())
+          continue;
+        int** table = preprocess(patterns[i].c_str(), alphabet_.c_str());
+        occurrences += bmsearch(text_.c_str(), patterns[i].c_str(), table,
+                                alphabet_.c_str());
+        freetable(table, patterns[i].size());
+      }
+      break;
+    case kAhoCorasick: {
+      // An empty keyword would match at the root
+      vector<string> keywords;
+      for (size_t i = 0; i < patterns.size(); ++i)
+        if (!patterns[i].empty())
+          keywords.push_back(patterns[i]);
+      buildMatchingMachine(keywords);
+      int state = 0;
+      for (size_t i = 0; i < text_.size(); ++i) {
+        state = findNextState(state, text_[i]);
+        occurrences += out[state].count();
+      }
+      break;
+    }
+    default:
+      if (!tree_) {
+        tree_ = new suffixtree::SuffixTree(text_);
+        tree_->Build();
+      }
+      for (size_t i = 0; i < patterns.size(); ++i)
+        occurrences += tree_->Count(patterns[i]);
+      break;
+  }
+  return occurrences;
+}
+
+long Count(const CostModel& model, const string& text,
+           const vector<string>& patterns, size_t queries) {
+  return Searcher(model, text, queries).Count(patterns);
+}
+
+}  // namespace selector
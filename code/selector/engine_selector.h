@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Adaptive engine selection
+ *
+ * Predicts the running time of every engine on a workload with a linear
+ * cost model per phase, picks the cheapest one and runs it (Count() and
+ * Searcher). Whichever engine is picked, the result is the number of
+ * occurrences of the patterns in the text; empty patterns occur nowhere.
+ * Aho-Corasick and the suffix tree only handle the characters ' ' to '~',
+ * so other texts and patterns are always searched with Boyer-Moore, which
+ * takes any character but '\0'. The coefficients are
+ * calibrated on the local machine by the benchmark (bench --calibrate=FILE)
+ * and read back from that profile file; the built-in defaults were measured
+ * on the development machine.
+ ******************************************************************************/
+#ifndef ENGINE_SELECTOR_H_
+#define ENGINE_SELECTOR_H_
+
+#include <string>
+#include <vector>
+
+namespace suffixtree {
+class SuffixTree;
+}  // namespace suffixtree
+
+namespace selector {
+
+enum Engine {
+  kBoyerMoore,
+  kAhoCorasick,
+  kSuffixTree,
+  kEngineNum
+};
+
+enum Phase {
+  kPreprocess,
+  kSearch,
+  kPhaseNum
+};
+
+extern const char* const kEngineNames[kEngineNum];   // "bm", "ac", "st"
+extern const char* const kPhaseNames[kPhaseNum];     // "preprocess", "search"
+
+// kEngineNum if there is no engine of that name
+Engine EngineByName(const std::string& name);
+
+struct Workload {
+  size_t text_length;
+  size_t alphabet_size;     // number of distinct characters of the text
+  size_t pattern_count;
+  size_t pattern_length;    // total length of all patterns
+  size_t queries;           // pattern sets searched for in the same text
+  bool printable;           // text and patterns only have ' ' to '~'
+
+  Workload()
+      : text_length(0)
+      , alphabet_size(0)
+      , pattern_count(0)
+      , pattern_length(0)
+      , queries(1)
+      , printable(true)
+  {}
+};
+
+Workload Describe(const std::string& text,
+                  const std::vector<std::string>& patterns,
+                  size_t queries);
+
+// The size each phase of an engine is assumed to be linear in
+double Feature(Engine engine, Phase phase, const Workload& workload);
+
+// True if all the characters of str are in ' ' to '~'
+bool Printable(const std::string& str);
+
+// False if the engine can't handle the workload at all
+bool Supports(Engine engine, const Workload& workload);
+
+class CostModel {
+ public:
+  CostModel();
+
+  // The profile has one "<engine> <phase> <fixed_us> <unit_us>" line per
+  // engine and phase; lines starting with '#' are comments. A profile that
+  // can't be read or parsed entirely leaves the model unchanged.
+  bool Load(const std::string& path);
+  bool Save(const std::string& path) const;
+
+  // Least squares fit of time_us = fixed_us + unit_us * feature, where
+  // time_us is the time of one execution of the phase
+  void Fit(Engine engine, Phase phase, const std::vector<double>& features,
+           const std::vector<double>& times_us);
+
+  // Predicted time of one phase summed over all the queries of the
+  // workload, in microseconds. The suffix tree preprocesses the text only
+  // once, and not at all if text_preprocessed is set.
+  double PredictPhase(Engine engine, Phase phase, const Workload& workload,
+                      bool text_preprocessed = false) const;
+  double Predict(Engine engine, const Workload& workload,
+                 bool text_preprocessed = false) const;
+  Engine Choose(const Workload& workload,
+                bool text_preprocessed = false) const;
+
+ private:
+  double fixed_us[kEngineNum][kPhaseNum];
+  double unit_us[kEngineNum][kPhaseNum];
+};
+
+// Searches pattern sets in one text with the engine the cost model picks
+// for each set. The suffix tree of the text is built once, the first time
+// it is picked, and reused by the following queries.
+class Searcher {
+ public:
+  // queries is the number of pattern sets the caller expects to search for
+  Searcher(const CostModel& model, const std::string& text, size_t queries);
+  ~Searcher();
+
+  // Returns the number of occurrences of all the patterns in the text
+  long Count(const std::vector<std::string>& patterns);
+
+  // The engine used by the last Count()
+  Engine last_engine() const {
+    return last_engine_;
+  }
+
+ private:
+  const CostModel& model_;
+  std::string text_;
+  std::string alphabet_;
+  bool text_printable_;
+  size_t queries_left_;
+  suffixtree::SuffixTree* tree_;
+  Engine last_engine_;
+
+  Searcher(const Searcher&);
+  void operator=(const Searcher&);
+};
+
+// One-shot convenience: Searcher(model, text, queries).Count(patterns)
+long Count(const CostModel& model, const std::string& text,
+           const std::vector<std::string>& patterns, size_t queries = 1);
+
+}  // namespace selector
+
+#endif  // ENGINE_SELECTOR_H_
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "suffix_tree.h"
+#include "../counters/counters.h"
 
 using std::string;
 using std::vector;
@@ -103,6 +104,8 @@ void SuffixTree::Build() {
       }
     }
   }
+
+  CountLeaves();
 }
 
 bool SuffixTree::AddSuffixImplicitly() {
@@ -117,6 +120,7 @@ bool SuffixTree::NormalizeActivePoint() {
   size_t next_suffix_start_index = current_suffix_start_index + 1;
   bool active_node_was_updated = false;
   while (active.length > 0 && active.length > active.edge->length()) {
+    COUNT(kStNormalizeIterations);
     active.length -= active.edge->length() + 1;
     active.node = active.edge->tail;
     active.edge = active.length > 0 ?
@@ -143,14 +147,20 @@ void SuffixTree::InsertEdge() {
                                                       NULL);
   // Reassign active point according to RULE 3
   // No need to change the edge, it will stay NULL
-  active.node = active.node->suffix_link &&
-                active.node->depth > active.node->suffix_link->depth ?
-      active.node->suffix_link : ROOT;
+  if (active.node->suffix_link &&
+      active.node->depth > active.node->suffix_link->depth) {
+    COUNT(kStSuffixLinkTraversals);
+    active.node = active.node->suffix_link;
+  } else {
+    active.node = ROOT;
+  }
   --unresolved_suffixes;
 }
 
 // Split the edge from implicit position
 void SuffixTree::SplitEdge() {
+  COUNT(kStEdgeSplits);
+
   // Create a split node
   nodes.push_back(Node(active.node->depth + active.length));
   Node* created_node = &*(nodes.end() - 1);
@@ -188,7 +198,12 @@ void SuffixTree::UpdateActivePointAfterEdgeSplitting() {
           &(active.node->edges[the_string[next_suffix_start_index]]) : NULL;
   } else {
     // if active node is not ROOT (RULES 3)
-    active.node = active.node->suffix_link ? active.node->suffix_link : ROOT;
+    if (active.node->suffix_link) {
+      COUNT(kStSuffixLinkTraversals);
+      active.node = active.node->suffix_link;
+    } else {
+      active.node = ROOT;
+    }
     size_t new_from = active.edge->from;
     active.edge = &active.node->edges[the_string[new_from]];
   }
@@ -212,11 +227,13 @@ int SuffixTree::Match(string pattern) const {
   int pos_in_string = 0;
   for (size_t i = 0; i < pattern.size(); ++i) {
     // if we were in an explicit node
-    if (!current_edge)
+    if (!current_edge) {
+      COUNT(kStMatchNodeVisits);
       if (current_node->edges[pattern[i]].exists)
         current_edge = &current_node->edges[pattern[i]];
       else
         return -1;
+    }
 
     // if we are in an implicit node
     if (pattern[i] == the_string[current_edge->from + edge_ind])
@@ -237,5 +254,77 @@ int SuffixTree::Match(string pattern) const {
   return pos_in_string - pattern.size();
 }
 
+// Every occurrence of the pattern is a suffix of the string starting with
+// it, and thus a leaf below the point where the pattern ends in the tree.
+int SuffixTree::Count(string pattern) const {
+  if (pattern.empty())
+    return 0;
+
+  // Canonize the pattern; characters outside the alphabet occur nowhere
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    pattern[i] -= FIRST_ALPHABET_CHARACTER;
+    if (pattern[i] < 0 || pattern[i] >= static_cast<char>(ALPHABET_SIZE))
+      return 0;
+  }
+
+  const Node* current_node = ROOT;
+  const Edge* current_edge = NULL;
+  const Edge* last_edge = NULL;
+  size_t edge_ind = 0;
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    // if we were in an explicit node
+    if (!current_edge) {
+      COUNT(kStMatchNodeVisits);
+      if (current_node->edges[pattern[i]].exists)
+        current_edge = &current_node->edges[pattern[i]];
+      else
+        return 0;
+    }
+
+    // if we are in an implicit node
+    if (pattern[i] == the_string[current_edge->from + edge_ind])
+      ++edge_ind;
+    else
+      return 0;
+
+    last_edge = current_edge;
+
+    // check if we reached the next explicit node
+    if (current_edge->from + edge_ind > current_edge->to) {
+      current_node = current_edge->tail;
+      current_edge = NULL;
+      edge_ind = 0;
+    }
+  }
+
+  return last_edge->tail ? last_edge->tail->leaves : 1;
+}
+
+// Leaf edges have no tail node. The nodes are listed parents first with an
+// explicit stack, as the tree of a repetitive string can be as deep as the
+// string is long, and summed up children first.
+void SuffixTree::CountLeaves() {
+  vector<Node*> order;
+  vector<Node*> stack(1, ROOT);
+  while (!stack.empty()) {
+    Node* node = stack.back();
+    stack.pop_back();
+    order.push_back(node);
+    for (size_t c = 0; c < node->edges.size(); ++c)
+      if (node->edges[c].exists && node->edges[c].tail)
+        stack.push_back(node->edges[c].tail);
+  }
+
+  for (size_t i = order.size(); i-- > 0; ) {
+    Node* node = order[i];
+    node->leaves = 0;
+    for (size_t c = 0; c < node->edges.size(); ++c) {
+      const Edge& edge = node->edges[c];
+      if (edge.exists)
+        node->leaves += edge.tail ? edge.tail->leaves : 1;
+    }
+  }
+}
+
 }  // namespace suffixtree
 
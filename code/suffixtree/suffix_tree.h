@@ -24,10 +24,15 @@ class SuffixTree {
 
   int Match(string pattern) const;
 
+  // Number of occurrences of the pattern in the string
+  int Count(string pattern) const;
+
  private:
-  static const size_t ALPHABET_SIZE = 94;   // we use all symbols from ' ' to '~'
+  static const size_t ALPHABET_SIZE = 95;   // we use all symbols from ' ' to '~'
   static const char FIRST_ALPHABET_CHARACTER = ' ';
-  static const char SENTINEL_SIGN = static_cast<char>(27);
+  // Follows the canonized alphabet, so no character of the string ends a
+  // suffix the way the sentinel does
+  static const char SENTINEL_SIGN = static_cast<char>(ALPHABET_SIZE);
 
   struct Node;
   struct Edge;
@@ -37,11 +42,13 @@ class SuffixTree {
     size_t depth;
     Node* suffix_link;
     vector<Edge> edges;
+    int leaves;     // number of suffixes below, set once the tree is built
 
     explicit Node(size_t node_depth)
         : depth(node_depth)
         , suffix_link(NULL)
         , edges(ALPHABET_SIZE + 1)  // +1 for SENTINEL_SIGN
+        , leaves(0)
     {}
   };
 
@@ -104,6 +111,7 @@ class SuffixTree {
   bool NormalizeActivePoint();
   void UpdateActivePointAfterEdgeSplitting();
   void CreateSuffixLink(Node* node);
+  void CountLeaves();
 };
 
 }  // namespace suffixtree
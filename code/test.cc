@@ -2,16 +2,23 @@
  * Tests for pattern matching algorithms
  * Copyright 2013, Maruan Al-Shedivat
  ******************************************************************************/
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <vector>
 #include "suffixtree/suffix_tree.h"
+#include "../ahocorasick/ac.h"
+#include "BM/BoyreMoore/BoyreMoore/BoyreMoore.h"
+#include "fixed/data_constants.h"
+#include "fixed/fixed_matchers.h"
+#include "selector/engine_selector.h"
 
 using std::cout;
 using std::endl;
 using std::string;
 
-const int kTestNum = 3;   // Number of tests to perform
+const int kTestNum = 10;  // Number of tests to perform
 typedef bool (*Test) ();  // Pointer to a test function
 
 bool test1() {
@@ -53,8 +60,309 @@ bool test3() {
   return (match1 == 2 && match2 < 0);
 }
 
+bool test4() {
+  string text = "abbabababa";
+  string pattern1 = "aba";
+  string pattern2 = "abbc";
+  char* alphabet = extractalphabet(text.c_str());
+  int** table1 = preprocess(pattern1.c_str(), alphabet);
+  int** table2 = preprocess(pattern2.c_str(), alphabet);
+
+  int occ1 = bmsearch(text.c_str(), pattern1.c_str(), table1, alphabet);
+  int occ2 = bmsearch(text.c_str(), pattern2.c_str(), table2, alphabet);
+
+  freetable(table1, pattern1.size());
+  freetable(table2, pattern2.size());
+  delete[] alphabet;
+  return (occ1 == 3 && occ2 == 0);
+}
+
+bool test5() {
+  string text = "Hey!hishers";
+  std::vector<string> keywords;
+  keywords.push_back("Hey!");
+  keywords.push_back("she");
+  keywords.push_back("hers");
+  keywords.push_back("his");
+  keywords.push_back("hiss");
+  buildMatchingMachine(keywords);
+
+  int occ[5] = {0, 0, 0, 0, 0};
+  int state = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    state = findNextState(state, text[i]);
+    for (size_t j = 0; j < keywords.size(); ++j)
+      if (out[state][j])
+        ++occ[j];
+  }
+
+  return (occ[0] == 1 && occ[1] == 1 && occ[2] == 1 && occ[3] == 1 &&
+          occ[4] == 0);
+}
+
+bool test6() {
+  string text(100000, 'a');
+  std::vector<string> patterns(10, "abc");
+  selector::CostModel model;
+
+  selector::Workload one_shot = selector::Describe(text, patterns, 1);
+  selector::Workload repeated = selector::Describe(text, patterns, 100000);
+  patterns.resize(MAXW + 1);
+  selector::Workload too_many = selector::Describe(text, patterns, 1);
+
+  return (model.Choose(one_shot) != selector::kSuffixTree &&
+          model.Choose(repeated) == selector::kSuffixTree &&
+          !selector::Supports(selector::kAhoCorasick, too_many));
+}
+
+constexpr char kAba[] = "aba";
+constexpr char kAbbc[] = "abbc";
+constexpr char kHey[] = "Hey!";
+constexpr char kShe[] = "she";
+constexpr char kHers[] = "hers";
+constexpr char kHis[] = "his";
+// Overlapping patterns, prefixes of each other, and one longer than the
+// short text of test7
+constexpr char kA[] = "a";
+constexpr char kAa[] = "aa";
+constexpr char kAaa[] = "aaa";
+constexpr char kAb[] = "ab";
+constexpr char kAbab[] = "abab";
+constexpr char kBab[] = "bab";
+constexpr char kTilde[] = "b~ a";
+constexpr char kLong[] = "abababababababababababababababababababab";
+// Characters the run time Aho-Corasick doesn't accept
+constexpr char kTab[] = "\ta";
+constexpr char kHigh[] = "\xff\xff";
+constexpr char kMixed[] = "a\x80" "b";
+
+// The run time engines and a naive search for reference
+long RuntimeBoyerMoore(const string& text, const char* pattern) {
+  char* alphabet = extractalphabet(text.c_str());
+  int** table = preprocess(pattern, alphabet);
+  long occurrences = bmsearch(text.c_str(), pattern, table, alphabet);
+  freetable(table, string(pattern).size());
+  delete[] alphabet;
+  return occurrences;
+}
+
+long RuntimeAhoCorasick(const string& text,
+                        const std::vector<string>& keywords) {
+  buildMatchingMachine(keywords);
+  long occurrences = 0;
+  int state = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    state = findNextState(state, text[i]);
+    for (size_t j = 0; j < keywords.size(); ++j)
+      if (out[state][j])
+        ++occurrences;
+  }
+  return occurrences;
+}
+
+long NaiveCount(const string& text, const std::vector<string>& patterns) {
+  long occurrences = 0;
+  for (size_t i = 0; i < text.size(); ++i)
+    for (size_t j = 0; j < patterns.size(); ++j)
+      if (text.compare(i, patterns[j].size(), patterns[j]) == 0)
+        ++occurrences;
+  return occurrences;
+}
+
+template <const char* Pattern>
+bool SameAsBmsearch(const string& text) {
+  long occurrences = fixed::BoyerMoore<Pattern>::Count(text.c_str(),
+                                                        text.size());
+  return occurrences == RuntimeBoyerMoore(text, Pattern);
+}
+
+bool test7() {
+  string text1 = "abbabababa";
+  string text2 = "Hey!hishers";
+
+  long occ1 = fixed::BoyerMoore<kAba>::Count(text1.c_str(), text1.size());
+  long occ2 = fixed::BoyerMoore<kAbbc>::Count(text1.c_str(), text1.size());
+  long occ3 = fixed::AhoCorasick<kHey, kShe, kHers, kHis>::Count(
+      text2.c_str(), text2.size());
+  long occ4 = fixed::AhoCorasick<kAba>::Count(text1.c_str(), text1.size());
+  if (occ1 != 3 || occ2 != 0 || occ3 != 4 || occ4 != 3)
+    return false;
+
+  // A text with long runs and repetitions of the pattern characters
+  string text;
+  unsigned int random = 1;
+  for (int i = 0; i < 20000; ++i) {
+    random = random * 1103515245 + 12345;
+    text += "aaab~ "[(random >> 16) % 6];
+    if ((random >> 8) % 50 == 0)
+      text += "abababababababababababababababababababababab";
+  }
+  string short_text = "abab";
+
+  // The fixed matchers against bmsearch() and the findNextState() loop
+  const string texts[] = {text, short_text};
+  std::vector<string> keywords;
+  keywords.push_back(kA);
+  keywords.push_back(kAa);
+  keywords.push_back(kAaa);
+  keywords.push_back(kAb);
+  keywords.push_back(kAbab);
+  keywords.push_back(kBab);
+  keywords.push_back(kTilde);
+  keywords.push_back(kLong);
+  keywords.push_back(kAb);
+  for (const string& t : texts) {
+    if (!SameAsBmsearch<kA>(t) || !SameAsBmsearch<kAa>(t) ||
+        !SameAsBmsearch<kAaa>(t) || !SameAsBmsearch<kAb>(t) ||
+        !SameAsBmsearch<kAbab>(t) || !SameAsBmsearch<kBab>(t) ||
+        !SameAsBmsearch<kTilde>(t) || !SameAsBmsearch<kLong>(t))
+      return false;
+    long occurrences = fixed::AhoCorasick<
+        kA, kAa, kAaa, kAb, kAbab, kBab, kTilde, kLong, kAb>::Count(
+            t.c_str(), t.size());
+    if (occurrences != RuntimeAhoCorasick(t, keywords))
+      return false;
+  }
+  if (fixed::BoyerMoore<kLong>::Count(short_text.c_str(),
+                                      short_text.size()) != 0)
+    return false;
+
+  // bmsearch() takes any character but '\0', the run time Aho-Corasick only
+  // ' ' to '~', so there the fixed one is checked against a naive search
+  string raw_text = text;
+  for (size_t i = 0; i < raw_text.size(); i += 7)
+    raw_text[i] = "\t\xff\x80\n"[i % 4];
+  std::vector<string> raw_patterns;
+  raw_patterns.push_back(kTab);
+  raw_patterns.push_back(kHigh);
+  raw_patterns.push_back(kMixed);
+  raw_patterns.push_back(kAb);
+  long raw_occurrences = fixed::AhoCorasick<kTab, kHigh, kMixed, kAb>::Count(
+      raw_text.c_str(), raw_text.size());
+  return (SameAsBmsearch<kTab>(raw_text) && SameAsBmsearch<kHigh>(raw_text) &&
+          SameAsBmsearch<kMixed>(raw_text) && SameAsBmsearch<kAb>(raw_text) &&
+          raw_occurrences == NaiveCount(raw_text, raw_patterns) &&
+          raw_occurrences > 0);
+}
+
+bool test8() {
+  string text;
+  for (int i = 0; i < 1000; ++i)
+    text += "abbabababa";
+  std::vector<string> patterns;
+  patterns.push_back("aba");
+  patterns.push_back("abbc");
+  patterns.push_back("b");
+  selector::CostModel model;
+
+  suffixtree::SuffixTree st(text);
+  st.Build();
+  int count1 = st.Count(patterns[0]);
+  int count2 = st.Count(patterns[1]);
+  int count3 = st.Count(patterns[2]);
+
+  // Whichever engine is picked, the result is the number of occurrences
+  selector::Searcher one_shot(model, text, 1);
+  long occ1 = one_shot.Count(patterns);
+  selector::Searcher repeated(model, text, 100000);
+  long occ2 = repeated.Count(patterns);
+  long occ3 = selector::Count(model, text, patterns);
+
+  return (count1 == 3000 && count2 == 0 && count3 == 5000 &&
+          one_shot.last_engine() != selector::kSuffixTree &&
+          repeated.last_engine() == selector::kSuffixTree &&
+          occ1 == 8000 && occ2 == 8000 && occ3 == 8000);
+}
+
+// Every line of a data file, without the header of the two_patterns.txt
+// files and everything from the ',' on
+std::vector<string> ReadLines(const string& path, bool csv) {
+  std::ifstream file(path.c_str());
+  std::vector<string> lines;
+  string line;
+  if (csv)
+    std::getline(file, line);
+  while (std::getline(file, line))
+    lines.push_back(csv ? line.substr(0, line.find(',')) : line);
+  return lines;
+}
+
+// The patterns of two_patterns.txt are its lines in order; those of
+// 100_patterns.txt a subset, where line i is i characters long
+bool SameLines(const std::vector<string>& lines, const char* const* patterns,
+               size_t count, bool by_length) {
+  for (size_t i = 0; i < count; ++i) {
+    size_t line = by_length ? string(patterns[i]).size() - 1 : i;
+    if (line >= lines.size() || lines[line] != patterns[i])
+      return false;
+  }
+  return true;
+}
+
+bool test9() {
+  using namespace fixed::data;
+  return (SameLines(ReadLines("../data/dna/two_patterns.txt", true),
+                    kDnaTwoPatterns, std::size(kDnaTwoPatterns), false) &&
+          SameLines(ReadLines("../data/plain_text/two_patterns.txt", true),
+                    kTextTwoPatterns, std::size(kTextTwoPatterns), false) &&
+          SameLines(ReadLines("../data/dna/100_patterns.txt", false),
+                    kDnaPatterns, std::size(kDnaPatterns), true) &&
+          SameLines(ReadLines("../data/plain_text/100_patterns.txt", false),
+                    kTextPatterns, std::size(kTextPatterns), true));
+}
+
+// A cost model that picks the engine whenever the engine can be used
+selector::CostModel Forcing(selector::Engine engine) {
+  selector::CostModel model;
+  for (int e = 0; e < selector::kEngineNum; ++e)
+    if (e != engine)
+      model.Fit(static_cast<selector::Engine>(e), selector::kSearch,
+                std::vector<double>(1, 0), std::vector<double>(1, 1e9));
+  return model;
+}
+
+bool test10() {
+  // ';' is a character like any other, not the end of the string
+  suffixtree::SuffixTree st("b;ab;;b;;");
+  st.Build();
+  if (st.Count(";") != 5 || st.Count(";;") != 2 || st.Count("b;") != 3)
+    return false;
+
+  string text;
+  string raw_text;
+  for (int i = 0; i < 100; ++i) {
+    text += "abbabababa";
+    raw_text += "ab\nba;";
+  }
+  std::vector<string> patterns;
+  patterns.push_back("aba");
+  patterns.push_back("");
+  patterns.push_back("b");
+  std::vector<string> raw_patterns;
+  raw_patterns.push_back("b\nb");
+  raw_patterns.push_back("a;");
+  raw_patterns.push_back("~");
+  long raw_occurrences = NaiveCount(raw_text, raw_patterns);
+  raw_patterns.push_back("");
+
+  // Every engine gives the same count and ignores empty patterns; the ones
+  // limited to ' '..'~' give way to Boyer-Moore on other characters
+  for (int e = 0; e < selector::kEngineNum; ++e) {
+    selector::Engine engine = static_cast<selector::Engine>(e);
+    selector::CostModel model = Forcing(engine);
+    selector::Searcher searcher(model, text, 1);
+    selector::Searcher raw_searcher(model, raw_text, 1000);
+    if (searcher.Count(patterns) != 800 || searcher.last_engine() != engine ||
+        raw_searcher.Count(raw_patterns) != raw_occurrences ||
+        raw_searcher.last_engine() != selector::kBoyerMoore)
+      return false;
+  }
+  return raw_occurrences == 200;
+}
+
 int main() {
-  Test tests[3] = {test1, test2, test3};
+  Test tests[kTestNum] = {test1, test2, test3, test4, test5,
+                          test6, test7, test8, test9, test10};
   cout << "Performing tests..." << endl;
   for (int i = 0; i < kTestNum; ++i) {
     if (tests[i]())
@@ -1,4 +1,6 @@
 #!/bin/bash
-g++ -g test.cc suffixtree/suffix_tree.cc -o test
+g++ -std=c++17 -g -DAC_NO_MAIN -DBM_NO_MAIN test.cc suffixtree/suffix_tree.cc \
+    ../ahocorasick/ac.cpp BM/BoyreMoore/BoyreMoore/BoyreMoore.cpp \
+    selector/engine_selector.cc -o test
 ./test
 rm test